@@ -0,0 +1,249 @@
+/*
+    Implementation for module which computes the DTW distance between every
+        pair of a set of sequences.
+
+    The pairs (i, j) with i < j are numbered row by row, so a run of pairs
+        is a range of numbers. Every thread owns a range, guarded by its own
+        lock, and takes pairs from the front of it. A thief takes the back
+        half of the victim's range, so the owner and thief only ever
+        contend for the one lock while the range is split.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <pthread.h>
+#include "problem.h"
+#include "workspace.h"
+#include "allPairs.h"
+
+/* One thread's remaining run of pairs, next up to but not including end. */
+struct pairRange {
+    pthread_mutex_t lock;
+    long long next;
+    long long end;
+};
+
+/* Everything shared by the threads solving the pairs. */
+struct allPairs {
+    long double **sequences;
+    int *lengths;
+    int count;
+    int windowSize;
+    int threadCount;
+    /* The number of the first pair in each row, i.e. (i, i + 1). */
+    long long *rowStart;
+    long double *distances;
+    struct pairRange *ranges;
+};
+
+/* One thread's share of the work. */
+struct allPairsThread {
+    struct allPairs *a;
+    int threadIndex;
+    struct allPairsStats stats;
+};
+
+/* Takes the next pair from the thread's own range, returning 0 if empty. */
+static int takePair(struct pairRange *range, long long *pair);
+
+/*
+    Moves the back half of the largest other range to the thread's own 
+    range, returning 0 if every range is empty.
+*/
+static int stealPairs(struct allPairs *a, int threadIndex);
+
+/* Sets i and j to the sequences of the given pair. */
+static void decodePair(struct allPairs *a, long long pair, int *i, int *j);
+
+/* Solves pairs until there are none left. */
+static void *allPairsWorker(void *arg);
+
+static int takePair(struct pairRange *range, long long *pair){
+    int taken = 0;
+    pthread_mutex_lock(&(range->lock));
+    if(range->next < range->end){
+        *pair = range->next;
+        range->next++;
+        taken = 1;
+    }
+    pthread_mutex_unlock(&(range->lock));
+    return taken;
+}
+
+static int stealPairs(struct allPairs *a, int threadIndex){
+    while(1){
+        /* Pick the victim, then check it still has pairs under its lock. */
+        int victim = -1;
+        long long mostLeft = 0;
+        for(int t = 0; t < a->threadCount; t++){
+            pthread_mutex_lock(&(a->ranges[t].lock));
+            long long left = a->ranges[t].end - a->ranges[t].next;
+            pthread_mutex_unlock(&(a->ranges[t].lock));
+            if(t != threadIndex && left > mostLeft){
+                victim = t;
+                mostLeft = left;
+            }
+        }
+        if(victim < 0){
+            return 0;
+        }
+
+        struct pairRange *range = &(a->ranges[victim]);
+        long long stolenStart = 0;
+        long long stolenEnd = 0;
+        pthread_mutex_lock(&(range->lock));
+        if(range->next < range->end){
+            stolenEnd = range->end;
+            stolenStart = range->next + (range->end - range->next) / 2;
+            range->end = stolenStart;
+        }
+        pthread_mutex_unlock(&(range->lock));
+        if(stolenStart < stolenEnd){
+            struct pairRange *own = &(a->ranges[threadIndex]);
+            pthread_mutex_lock(&(own->lock));
+            own->next = stolenStart;
+            own->end = stolenEnd;
+            pthread_mutex_unlock(&(own->lock));
+            return 1;
+        }
+        /* The victim finished its range first, look again. */
+    }
+}
+
+static void decodePair(struct allPairs *a, long long pair, int *i, int *j){
+    /* The last row whose first pair is at or before this one. */
+    int low = 0;
+    int high = a->count - 2;
+    while(low < high){
+        int middle = (low + high + 1) / 2;
+        if(a->rowStart[middle] <= pair){
+            low = middle;
+        } else {
+            high = middle - 1;
+        }
+    }
+    *i = low;
+    *j = low + 1 + (int) (pair - a->rowStart[low]);
+}
+
+static void *allPairsWorker(void *arg){
+    struct allPairsThread *thread = (struct allPairsThread *) arg;
+    struct allPairs *a = thread->a;
+    struct pairRange *own = &(a->ranges[thread->threadIndex]);
+    struct workspace *workspace = newWorkspace();
+    long long pair;
+
+    while(1){
+        if(! takePair(own, &pair)){
+            if(! stealPairs(a, thread->threadIndex)){
+                break;
+            }
+            thread->stats.steals++;
+            continue;
+        }
+        int i, j;
+        decodePair(a, pair, &i, &j);
+
+        struct problem *problem;
+        struct solution *solution;
+        if(a->windowSize >= 0){
+            problem = newProblemD(a->sequences[i], a->lengths[i], 
+                a->sequences[j], a->lengths[j], a->windowSize);
+            setProblemWorkspace(problem, workspace);
+            solution = solveProblemD(problem);
+        } else {
+            /* Only the distance is needed, so keep two rolling rows. */
+            problem = newProblemA(a->sequences[i], a->lengths[i], 
+                a->sequences[j], a->lengths[j]);
+            setProblemWorkspace(problem, workspace);
+            solution = solveProblemADistance(problem);
+        }
+        long double distance = getOptimalValue(solution);
+        freeSolution(solution, problem);
+        freeProblem(problem);
+
+        a->distances[(size_t) i * a->count + j] = distance;
+        a->distances[(size_t) j * a->count + i] = distance;
+        thread->stats.pairs++;
+    }
+
+    freeWorkspace(workspace);
+    return NULL;
+}
+
+struct allPairsStats allPairsDTW(long double **sequences, int *lengths,
+    int count, int windowSize, int threadCount, long double *distances){
+    struct allPairs a;
+    struct allPairsStats stats = {0, 0};
+
+    if(threadCount < 1){
+        threadCount = 1;
+    }
+    a.sequences = sequences;
+    a.lengths = lengths;
+    a.count = count;
+    a.windowSize = windowSize;
+    a.threadCount = threadCount;
+    a.distances = distances;
+
+    /* A sequence is no distance from itself. */
+    for(int i = 0; i < count; i++){
+        distances[(size_t) i * count + i] = 0;
+    }
+    if(count < 2){
+        return stats;
+    }
+
+    a.rowStart = (long long *) malloc(sizeof(long long) * count);
+    assert(a.rowStart);
+    long long pairs = 0;
+    for(int i = 0; i < count; i++){
+        a.rowStart[i] = pairs;
+        pairs += count - 1 - i;
+    }
+
+    /* Every thread starts with an equal run of pairs. */
+    a.ranges = (struct pairRange *) malloc(sizeof(struct pairRange) * 
+        threadCount);
+    assert(a.ranges);
+    for(int t = 0; t < threadCount; t++){
+        pthread_mutex_init(&(a.ranges[t].lock), NULL);
+        a.ranges[t].next = pairs * t / threadCount;
+        a.ranges[t].end = pairs * (t + 1) / threadCount;
+    }
+
+    pthread_t *threads = (pthread_t *) malloc(sizeof(pthread_t) * threadCount);
+    assert(threads);
+    struct allPairsThread *threadArgs = (struct allPairsThread *)
+        malloc(sizeof(struct allPairsThread) * threadCount);
+    assert(threadArgs);
+
+    /* The calling thread does the first share of the work itself. */
+    for(int t = 0; t < threadCount; t++){
+        threadArgs[t].a = &a;
+        threadArgs[t].threadIndex = t;
+        threadArgs[t].stats.pairs = 0;
+        threadArgs[t].stats.steals = 0;
+        if(t > 0){
+            int status = pthread_create(&threads[t], NULL, allPairsWorker,
+                &threadArgs[t]);
+            assert(status == 0);
+        }
+    }
+    allPairsWorker(&threadArgs[0]);
+    for(int t = 1; t < threadCount; t++){
+        pthread_join(threads[t], NULL);
+    }
+
+    for(int t = 0; t < threadCount; t++){
+        stats.pairs += threadArgs[t].stats.pairs;
+        stats.steals += threadArgs[t].stats.steals;
+        pthread_mutex_destroy(&(a.ranges[t].lock));
+    }
+    free(threads);
+    free(threadArgs);
+    free(a.ranges);
+    free(a.rowStart);
+
+    return stats;
+}
@@ -0,0 +1,34 @@
+/*
+    Header for module which computes the DTW distance between every pair of
+        a set of sequences, sharing the pairs out among threads.
+
+    DTW is symmetric, so only the pairs above the diagonal are solved. Each
+        thread starts with an equal run of pairs and, once it runs out,
+        steals half of what is left of the longest remaining run, so threads
+        given the expensive pairs don't hold up the others. Each thread
+        keeps one workspace (see workspace.h) which every solve it runs
+        reuses.
+*/
+
+#ifndef ALLPAIRS_H
+#define ALLPAIRS_H
+
+/* How the work was shared out among the threads. */
+struct allPairsStats {
+    /* Number of pairs solved. */
+    long long pairs;
+    /* Number of times a thread took pairs from another. */
+    long long steals;
+};
+
+/*
+    Sets distances[i * count + j] to the DTW distance between sequences i
+    and j (of lengths[i] and lengths[j] values), for every i and j, using
+    threadCount threads. The distance is windowed as in Part D if windowSize
+    is at least 0, otherwise unconstrained as in Part A. distances must hold
+    count * count values. Returns how the work was shared out.
+*/
+struct allPairsStats allPairsDTW(long double **sequences, int *lengths,
+    int count, int windowSize, int threadCount, long double *distances);
+
+#endif
@@ -0,0 +1,227 @@
+/*
+    Make using
+        make benchmarkMatrix
+
+    Run using
+        ./benchmarkMatrix [length]
+
+    where length is the length of both generated sequences (4000 by
+        default), for example:
+
+        ./benchmarkMatrix 5000
+
+    A full Part A matrix is filled in by the previous implementation, which
+        zeroed every cell and then set every cell to infinity before
+        computing it, and by solveProblemA with the row and tiled layouts.
+        The time each takes is printed with the cache misses it caused,
+        counted with perf_event_open where the kernel and hardware allow,
+        after checking that all give the same DTW distance.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "problem.h"
+
+#define LENGTH_ARG 1
+#define NUMBER_BASE (10)
+
+#define DEFAULT_LENGTH 4000
+
+/* The counters read around each run. */
+#define COUNTER_COUNT 2
+static const char *counterNames[COUNTER_COUNT] = {
+    "L1D read misses", "LLC misses"
+};
+
+/* Opens the counters, setting each unavailable one to -1. */
+void openCounters(int *counters);
+
+/* Resets and starts the counters. */
+void startCounters(int *counters);
+
+/* Stops the counters and reads them into counts. */
+void stopCounters(int *counters, long long *counts);
+
+/* Returns the seconds since an arbitrary point, for timing. */
+double secondsNow(void);
+
+/* The previous Part A matrix fill, kept to compare against. Returns the
+    DTW distance. */
+long double legacySolve(long double *seqA, int n, long double *seqB, int m);
+
+/* Prints one row of results. */
+void printResult(const char *name, double seconds, int *counters,
+    long long *counts);
+
+int main(int argc, char **argv){
+    int length = DEFAULT_LENGTH;
+    if(argc > LENGTH_ARG){
+        length = strtol(argv[LENGTH_ARG], NULL, NUMBER_BASE);
+    }
+    if(length < 1){
+        fprintf(stderr, "Run the program in the form \n"
+            "\t./benchmarkMatrix [length]\n");
+        return EXIT_FAILURE;
+    }
+
+    long double *seqA = (long double *) malloc(sizeof(long double) * length);
+    assert(seqA);
+    long double *seqB = (long double *) malloc(sizeof(long double) * length);
+    assert(seqB);
+    srand(20007);
+    for(int i = 0; i < length; i++){
+        seqA[i] = (long double) rand() / RAND_MAX;
+        seqB[i] = (long double) rand() / RAND_MAX;
+    }
+
+    int counters[COUNTER_COUNT];
+    long long counts[COUNTER_COUNT];
+    openCounters(counters);
+
+    printf("%d x %d matrix\n", length, length);
+
+    startCounters(counters);
+    double start = secondsNow();
+    long double legacyDistance = legacySolve(seqA, length, seqB, length);
+    double seconds = secondsNow() - start;
+    stopCounters(counters, counts);
+    printResult("previous", seconds, counters, counts);
+
+    enum matrixLayout layouts[] = {MATRIX_ROWS, MATRIX_TILES};
+    const char *layoutNames[] = {"rows", "tiles"};
+    for(int l = 0; l < 2; l++){
+        struct problem *problem = newProblemA(seqA, length, seqB, length);
+        setProblemMatrixLayout(problem, layouts[l]);
+        startCounters(counters);
+        start = secondsNow();
+        struct solution *solution = solveProblemA(problem);
+        seconds = secondsNow() - start;
+        stopCounters(counters, counts);
+        printResult(layoutNames[l], seconds, counters, counts);
+        if(getOptimalValue(solution) != legacyDistance){
+            fprintf(stderr, "The %s layout gave %.2Lf, not %.2Lf\n",
+                layoutNames[l], getOptimalValue(solution), legacyDistance);
+            return EXIT_FAILURE;
+        }
+        freeSolution(solution, problem);
+        freeProblem(problem);
+    }
+
+    for(int c = 0; c < COUNTER_COUNT; c++){
+        if(counters[c] != -1){
+            close(counters[c]);
+        }
+    }
+    free(seqA);
+    free(seqB);
+
+    return EXIT_SUCCESS;
+}
+
+void openCounters(int *counters){
+    unsigned long long configs[COUNTER_COUNT] = {
+        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+        PERF_COUNT_HW_CACHE_MISSES
+    };
+    unsigned int types[COUNTER_COUNT] = {
+        PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE
+    };
+    for(int c = 0; c < COUNTER_COUNT; c++){
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = types[c];
+        attr.config = configs[c];
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        counters[c] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if(counters[c] < 0){
+            counters[c] = -1;
+        }
+    }
+}
+
+void startCounters(int *counters){
+    for(int c = 0; c < COUNTER_COUNT; c++){
+        if(counters[c] != -1){
+            ioctl(counters[c], PERF_EVENT_IOC_RESET, 0);
+            ioctl(counters[c], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+void stopCounters(int *counters, long long *counts){
+    for(int c = 0; c < COUNTER_COUNT; c++){
+        counts[c] = -1;
+        if(counters[c] != -1){
+            ioctl(counters[c], PERF_EVENT_IOC_DISABLE, 0);
+            if(read(counters[c], &counts[c], sizeof(long long)) !=
+                sizeof(long long)){
+                counts[c] = -1;
+            }
+        }
+    }
+}
+
+double secondsNow(void){
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+void printResult(const char *name, double seconds, int *counters,
+    long long *counts){
+    printf("%-8s %8.3f s", name, seconds);
+    for(int c = 0; c < COUNTER_COUNT; c++){
+        if(counts[c] == -1){
+            printf(", %s unavailable", counterNames[c]);
+        } else {
+            printf(", %lld %s", counts[c], counterNames[c]);
+        }
+    }
+    printf("\n");
+}
+
+long double legacySolve(long double *seqA, int n, long double *seqB, int m){
+    long double *cells = (long double *) malloc(sizeof(long double) *
+        (n + 1) * (m + 1));
+    assert(cells);
+    long double **matrix = (long double **) malloc(sizeof(long double *) *
+        (n + 1));
+    assert(matrix);
+    for(int i = 0; i <= n; i++){
+        matrix[i] = cells + (size_t) i * (m + 1);
+        for(int j = 0; j <= m; j++){
+            matrix[i][j] = 0;
+        }
+    }
+    for(int i = 0; i <= n; i++){
+        for(int j = 0; j <= m; j++){
+            matrix[i][j] = LDINFINITY;
+        }
+    }
+    matrix[0][0] = 0;
+
+    for(int i = 1; i <= n; i++){
+        for(int j = 1; j <= m; j++){
+            long double cost = fabsl(seqA[i-1] - seqB[j-1]);
+            matrix[i][j] = cost + fminl(matrix[i-1][j],
+                fminl(matrix[i][j-1], matrix[i-1][j-1]));
+        }
+    }
+    long double distance = matrix[n][m];
+
+    free(matrix);
+    free(cells);
+
+    return distance;
+}
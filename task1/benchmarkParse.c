@@ -0,0 +1,170 @@
+/*
+    Make using
+        make benchmarkParse
+
+    Run using
+        ./benchmarkParse [values [digits]]
+
+    where values is how many values to put in a generated sequence file
+        (100000 by default) and digits is how many digits after the
+        decimal point each has in scientific notation (2 by default, as in
+        test_cases), for example:
+
+        ./benchmarkParse 50000 17
+
+    The generated file is parsed by the previous getdelim and sscanf
+        implementation of readSequence and by the current one, and the
+        throughput of each is printed in MB/s, after checking that both
+        give exactly the same values.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "problem.h"
+
+#define VALUES_ARG 1
+#define DIGITS_ARG 2
+#define NUMBER_BASE (10)
+
+#define DEFAULT_VALUES 100000
+#define DEFAULT_DIGITS 2
+
+/* Each parser is timed this many times, keeping the fastest. */
+#define REPEATS 5
+
+#define BYTES_PER_MB (1024.0 * 1024.0)
+
+/* Written ahead of the generated values, as spellings the parser has to
+    give the same sign and value for as sscanf. */
+static const char *edgeValues[] = {"-0", "-0.0", "-0e5", "+0", "0.0"};
+#define EDGE_VALUE_COUNT (sizeof(edgeValues) / sizeof(edgeValues[0]))
+
+/* The getdelim and sscanf readSequence, kept to compare against. */
+void legacyReadSequence(FILE *seqFile, int *seqLen, long double **seq);
+
+/* Returns the fastest time in seconds reader takes to read fileName. */
+double timeReader(void (*reader)(FILE *, int *, long double **),
+    char *fileName, int *seqLen, long double **seq);
+
+int main(int argc, char **argv){
+    int valueCount = DEFAULT_VALUES;
+    int digits = DEFAULT_DIGITS;
+
+    if(argc > VALUES_ARG){
+        valueCount = strtol(argv[VALUES_ARG], NULL, NUMBER_BASE);
+    }
+    if(argc > DIGITS_ARG){
+        digits = strtol(argv[DIGITS_ARG], NULL, NUMBER_BASE);
+    }
+    if(valueCount < 1 || digits < 0){
+        fprintf(stderr, "Run the program in the form \n"
+            "\t./benchmarkParse [values [digits]]\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Generate values in the same style as the test cases. */
+    char fileName[] = "/tmp/benchmarkParseXXXXXX";
+    int fd = mkstemp(fileName);
+    assert(fd != -1);
+    FILE *seqFile = fdopen(fd, "w");
+    assert(seqFile);
+    for(size_t i = 0; i < EDGE_VALUE_COUNT; i++){
+        fprintf(seqFile, "%s, ", edgeValues[i]);
+    }
+    srand(20007);
+    for(int i = 0; i < valueCount; i++){
+        long double value = ((long double) rand() / RAND_MAX - 0.5L) *
+            powl(10.0L, rand() % 7 - 3);
+        fprintf(seqFile, "%s%.*LE", (i == 0) ? "" : ", ", digits, value);
+    }
+    fprintf(seqFile, "\n");
+    long fileSize = ftell(seqFile);
+    fclose(seqFile);
+    double megabytes = fileSize / BYTES_PER_MB;
+
+    int legacyLength, currentLength;
+    long double *legacy, *current;
+    double legacyTime = timeReader(legacyReadSequence, fileName,
+        &legacyLength, &legacy);
+    double currentTime = timeReader(readSequence, fileName,
+        &currentLength, &current);
+    remove(fileName);
+
+    int mismatches = 0;
+    assert(legacyLength == currentLength);
+    for(int i = 0; i < currentLength; i++){
+        if(legacy[i] != current[i] ||
+            signbit(legacy[i]) != signbit(current[i])){
+            mismatches++;
+        }
+    }
+    free(legacy);
+    free(current);
+
+    printf("%d values, %.2f MB\n", currentLength, megabytes);
+    printf("sscanf: %8.2f MB/s\n", megabytes / legacyTime);
+    printf("parser: %8.2f MB/s (%.2fx)\n", megabytes / currentTime,
+        legacyTime / currentTime);
+    printf("%d values differ\n", mismatches);
+
+    return mismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+void legacyReadSequence(FILE *seqFile, int *seqLen, long double **seq){
+    char *seqText = NULL;
+    size_t allocated = 0;
+    int success = getdelim(&seqText, &allocated, '\0', seqFile);
+    assert(success > 0);
+
+    int progress = 0;
+    int seqTextLength = strlen(seqText);
+
+    int commaCount = 0;
+    for(int i = 0; i < seqTextLength; i++){
+        if(seqText[i] == ','){
+            commaCount++;
+        }
+    }
+    long double *seqLocal = (long double *) malloc(sizeof(long double) *
+        (commaCount + 1));
+    assert(seqLocal);
+
+    int seqAdded = 0;
+    while(progress < seqTextLength){
+        int nextProgress = seqTextLength - progress;
+        int scanned = sscanf(seqText + progress, "%Lf , %n",
+            &seqLocal[seqAdded], &nextProgress);
+        assert(scanned == 1);
+        progress += nextProgress;
+        seqAdded++;
+    }
+    assert(seqAdded == (commaCount + 1));
+    *seq = seqLocal;
+    *seqLen = seqAdded;
+    free(seqText);
+}
+
+double timeReader(void (*reader)(FILE *, int *, long double **),
+    char *fileName, int *seqLen, long double **seq){
+    double fastest = INFINITY;
+    *seq = NULL;
+    for(int repeat = 0; repeat < REPEATS; repeat++){
+        free(*seq);
+        FILE *seqFile = fopen(fileName, "r");
+        assert(seqFile);
+        struct timespec start, finish;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        reader(seqFile, seqLen, seq);
+        clock_gettime(CLOCK_MONOTONIC, &finish);
+        fclose(seqFile);
+        double seconds = (finish.tv_sec - start.tv_sec) +
+            (finish.tv_nsec - start.tv_nsec) / 1e9;
+        if(seconds < fastest){
+            fastest = seconds;
+        }
+    }
+    return fastest;
+}
@@ -0,0 +1,358 @@
+/*
+    Make using
+        make benchmarkWorkspace
+
+    Run using
+        ./benchmarkWorkspace [length [pairs]]
+
+    where length is the longest generated sequence (128 by default) and
+        pairs is how many pairs of sequences, each between half and all of
+        that length and within a twentieth of it of each other, are solved
+        in turn (8 by default), for example:
+
+        ./benchmarkWorkspace 256 16
+
+    Each kind of solve is run the way a caller without a workspace would,
+        creating a problem, solving it and freeing both every call, and
+        again with one problem pointed at each pair in turn with
+        setProblemSequences and solved from one workspace. The calls per
+        second and the heap allocations per call of each are printed, after
+        checking that both give the same DTW distances.
+
+    The program links against libdtw.a with malloc, calloc and realloc
+        wrapped, so every allocation the library makes is counted.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <time.h>
+#include "problem.h"
+#include "workspace.h"
+
+#define LENGTH_ARG 1
+#define PAIRS_ARG 2
+#define NUMBER_BASE (10)
+
+#define DEFAULT_LENGTH 128
+#define DEFAULT_PAIRS 8
+
+/* Each way of solving is timed this many times for at least this long, 
+    keeping the fastest. */
+#define REPEATS 5
+#define MINIMUM_SECONDS 0.2
+
+/* Which part's problem a case creates. */
+enum casePart {
+    CASE_PART_A,
+    CASE_PART_D,
+    CASE_PART_F
+};
+
+/* A kind of solve being timed. */
+struct benchmarkCase {
+    const char *name;
+    enum casePart part;
+    enum dtwPrecision precision;
+    int findPath;
+    struct solution *(*solve)(struct problem *p);
+};
+
+/* The generated pairs of sequences. */
+struct sequencePairs {
+    int count;
+    long double **seqA;
+    int *seqALength;
+    long double **seqB;
+    int *seqBLength;
+    /* The window size of Part D and path length of Part F problems, the 
+        same for every pair as a reused problem keeps them. */
+    int windowSize;
+    int maxPathLength;
+};
+
+/* Allocations counted since the program started. */
+static size_t allocationCount = 0;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *memory, size_t size);
+
+/* Count each allocation, then make it as usual. */
+void *__wrap_malloc(size_t size);
+void *__wrap_calloc(size_t count, size_t size);
+void *__wrap_realloc(void *memory, size_t size);
+
+/* Returns the seconds since an arbitrary point, for timing. */
+double secondsNow(void);
+
+/* Generates the given number of pairs up to the given length. */
+struct sequencePairs *newSequencePairs(int length, int count);
+
+/* Frees the pairs and their sequences. */
+void freeSequencePairs(struct sequencePairs *pairs);
+
+/* Creates a problem of the case's part over pair k, set up as the case
+    says. */
+struct problem *newCaseProblem(struct benchmarkCase *c,
+    struct sequencePairs *pairs, int k);
+
+/* Solves every pair in turn with a new problem each call, until 
+    MINIMUM_SECONDS have passed, REPEATS times. Returns the most calls per 
+    second, setting allocations to the allocations made per call. */
+double timeFresh(struct benchmarkCase *c, struct sequencePairs *pairs,
+    double *allocations);
+
+/* Same as timeFresh, but pointing one problem at each pair and solving it
+    from one workspace, after solving every pair once to grow the
+    workspace. */
+double timeReused(struct benchmarkCase *c, struct sequencePairs *pairs,
+    double *allocations);
+
+/* Solves every pair in turn until MINIMUM_SECONDS have passed, with a new 
+    problem each call or, if p is not NULL, pointing p at each pair. 
+    Returns the calls per second, adding the calls to calls. */
+double timeCalls(struct benchmarkCase *c, struct sequencePairs *pairs,
+    struct problem *p, long long *calls);
+
+/* Returns 1 if both ways of solving give the same distance for every
+    pair. */
+int sameDistances(struct benchmarkCase *c, struct sequencePairs *pairs);
+
+int main(int argc, char **argv){
+    int length = DEFAULT_LENGTH;
+    int pairCount = DEFAULT_PAIRS;
+    if(argc > LENGTH_ARG){
+        length = strtol(argv[LENGTH_ARG], NULL, NUMBER_BASE);
+    }
+    if(argc > PAIRS_ARG){
+        pairCount = strtol(argv[PAIRS_ARG], NULL, NUMBER_BASE);
+    }
+    if(length < 2 || pairCount < 1){
+        fprintf(stderr, "Run the program in the form \n"
+            "\t./benchmarkWorkspace [length [pairs]]\n");
+        return EXIT_FAILURE;
+    }
+
+    struct benchmarkCase cases[] = {
+        {"A matrix", CASE_PART_A, PRECISION_LONG_DOUBLE, 0, solveProblemA},
+        {"A distance", CASE_PART_A, PRECISION_LONG_DOUBLE, 0,
+            solveProblemADistance},
+        {"A double", CASE_PART_A, PRECISION_DOUBLE, 0,
+            solveProblemADistance},
+        {"A path", CASE_PART_A, PRECISION_LONG_DOUBLE, 1,
+            solveProblemADistance},
+        {"D band", CASE_PART_D, PRECISION_LONG_DOUBLE, 0, solveProblemD},
+        {"D distance", CASE_PART_D, PRECISION_LONG_DOUBLE, 0,
+            solveProblemDDistance},
+        {"F layers", CASE_PART_F, PRECISION_LONG_DOUBLE, 0, solveProblemF},
+        {"F double", CASE_PART_F, PRECISION_DOUBLE, 0, solveProblemF}
+    };
+    int caseCount = sizeof(cases) / sizeof(cases[0]);
+
+    struct sequencePairs *pairs = newSequencePairs(length, pairCount);
+
+    printf("%-12s %14s %10s %14s %10s %8s\n", "solve", "fresh calls/s",
+        "allocs", "reused calls/s", "allocs", "speedup");
+    for(int c = 0; c < caseCount; c++){
+        if(! sameDistances(&cases[c], pairs)){
+            fprintf(stderr, "%s: the distances differ\n", cases[c].name);
+            return EXIT_FAILURE;
+        }
+        double freshAllocations, reusedAllocations;
+        double fresh = timeFresh(&cases[c], pairs, &freshAllocations);
+        double reused = timeReused(&cases[c], pairs, &reusedAllocations);
+        printf("%-12s %14.1f %10.2f %14.1f %10.2f %7.2fx\n", cases[c].name,
+            fresh, freshAllocations, reused, reusedAllocations,
+            reused / fresh);
+    }
+
+    freeSequencePairs(pairs);
+
+    return EXIT_SUCCESS;
+}
+
+void *__wrap_malloc(size_t size){
+    allocationCount++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size){
+    allocationCount++;
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *memory, size_t size){
+    allocationCount++;
+    return __real_realloc(memory, size);
+}
+
+double secondsNow(void){
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+struct sequencePairs *newSequencePairs(int length, int count){
+    struct sequencePairs *pairs = (struct sequencePairs *)
+        malloc(sizeof(struct sequencePairs));
+    assert(pairs);
+    pairs->count = count;
+    pairs->seqA = (long double **) malloc(sizeof(long double *) * count);
+    assert(pairs->seqA);
+    pairs->seqB = (long double **) malloc(sizeof(long double *) * count);
+    assert(pairs->seqB);
+    pairs->seqALength = (int *) malloc(sizeof(int) * count);
+    assert(pairs->seqALength);
+    pairs->seqBLength = (int *) malloc(sizeof(int) * count);
+    assert(pairs->seqBLength);
+    /* Wide enough to reach (n, m), and a tenth of the length past the 
+        diagonal. */
+    pairs->windowSize = length / 10 + 1;
+    pairs->maxPathLength = length + length / 10;
+
+    srand(20007);
+    for(int k = 0; k < count; k++){
+        int n = length / 2 + rand() % (length - length / 2 + 1);
+        int m = n - rand() % (length / 20 + 1);
+        pairs->seqALength[k] = n;
+        pairs->seqBLength[k] = m;
+        pairs->seqA[k] = (long double *) malloc(sizeof(long double) * n);
+        assert(pairs->seqA[k]);
+        pairs->seqB[k] = (long double *) malloc(sizeof(long double) * m);
+        assert(pairs->seqB[k]);
+        for(int i = 0; i < n; i++){
+            pairs->seqA[k][i] = (long double) rand() / RAND_MAX;
+        }
+        for(int j = 0; j < m; j++){
+            pairs->seqB[k][j] = (long double) rand() / RAND_MAX;
+        }
+    }
+
+    return pairs;
+}
+
+void freeSequencePairs(struct sequencePairs *pairs){
+    for(int k = 0; k < pairs->count; k++){
+        free(pairs->seqA[k]);
+        free(pairs->seqB[k]);
+    }
+    free(pairs->seqA);
+    free(pairs->seqB);
+    free(pairs->seqALength);
+    free(pairs->seqBLength);
+    free(pairs);
+}
+
+struct problem *newCaseProblem(struct benchmarkCase *c,
+    struct sequencePairs *pairs, int k){
+    struct problem *p = NULL;
+    switch(c->part){
+        case CASE_PART_A:
+            p = newProblemA(pairs->seqA[k], pairs->seqALength[k],
+                pairs->seqB[k], pairs->seqBLength[k]);
+            break;
+        case CASE_PART_D:
+            p = newProblemD(pairs->seqA[k], pairs->seqALength[k],
+                pairs->seqB[k], pairs->seqBLength[k], pairs->windowSize);
+            break;
+        case CASE_PART_F:
+            p = newProblemF(pairs->seqA[k], pairs->seqALength[k],
+                pairs->seqB[k], pairs->seqBLength[k], pairs->maxPathLength);
+            break;
+    }
+    assert(p);
+    setProblemPrecision(p, c->precision);
+    setProblemWarpingPath(p, c->findPath);
+    return p;
+}
+
+double timeFresh(struct benchmarkCase *c, struct sequencePairs *pairs,
+    double *allocations){
+    double best = 0;
+    long long calls = 0;
+    size_t allocationsBefore = allocationCount;
+    for(int repeat = 0; repeat < REPEATS; repeat++){
+        double rate = timeCalls(c, pairs, NULL, &calls);
+        if(rate > best){
+            best = rate;
+        }
+    }
+    *allocations = (double) (allocationCount - allocationsBefore) / calls;
+    return best;
+}
+
+double timeReused(struct benchmarkCase *c, struct sequencePairs *pairs,
+    double *allocations){
+    struct workspace *workspace = newWorkspace();
+    struct problem *p = newCaseProblem(c, pairs, 0);
+    setProblemWorkspace(p, workspace);
+    /* Grow the workspace to the largest pair first. */
+    for(int k = 0; k < pairs->count; k++){
+        setProblemSequences(p, pairs->seqA[k], pairs->seqALength[k],
+            pairs->seqB[k], pairs->seqBLength[k]);
+        freeSolution(c->solve(p), p);
+    }
+
+    double best = 0;
+    long long calls = 0;
+    size_t allocationsBefore = allocationCount;
+    for(int repeat = 0; repeat < REPEATS; repeat++){
+        double rate = timeCalls(c, pairs, p, &calls);
+        if(rate > best){
+            best = rate;
+        }
+    }
+    *allocations = (double) (allocationCount - allocationsBefore) / calls;
+
+    freeProblem(p);
+    freeWorkspace(workspace);
+    return best;
+}
+
+double timeCalls(struct benchmarkCase *c, struct sequencePairs *pairs,
+    struct problem *p, long long *calls){
+    long long timedCalls = 0;
+    double start = secondsNow();
+    double elapsed;
+    do {
+        for(int k = 0; k < pairs->count; k++){
+            if(p){
+                setProblemSequences(p, pairs->seqA[k], pairs->seqALength[k],
+                    pairs->seqB[k], pairs->seqBLength[k]);
+                freeSolution(c->solve(p), p);
+            } else {
+                struct problem *fresh = newCaseProblem(c, pairs, k);
+                freeSolution(c->solve(fresh), fresh);
+                freeProblem(fresh);
+            }
+        }
+        timedCalls += pairs->count;
+        elapsed = secondsNow() - start;
+    } while(elapsed < MINIMUM_SECONDS);
+    *calls += timedCalls;
+    return timedCalls / elapsed;
+}
+
+int sameDistances(struct benchmarkCase *c, struct sequencePairs *pairs){
+    struct workspace *workspace = newWorkspace();
+    struct problem *reused = newCaseProblem(c, pairs, 0);
+    setProblemWorkspace(reused, workspace);
+    int same = 1;
+    for(int k = 0; k < pairs->count; k++){
+        struct problem *p = newCaseProblem(c, pairs, k);
+        struct solution *s = c->solve(p);
+        setProblemSequences(reused, pairs->seqA[k], pairs->seqALength[k],
+            pairs->seqB[k], pairs->seqBLength[k]);
+        struct solution *r = c->solve(reused);
+        if(getOptimalValue(s) != getOptimalValue(r)){
+            same = 0;
+        }
+        freeSolution(r, reused);
+        freeSolution(s, p);
+        freeProblem(p);
+    }
+    freeProblem(reused);
+    freeWorkspace(workspace);
+    return same;
+}
@@ -0,0 +1,126 @@
+/*
+    Make using
+        make checkAdaptive
+
+    Run using
+        ./checkAdaptive [pairs [length]]
+
+    where pairs is how many pairs of sequences to generate (20000 by
+        default) and length is the longest either may be (30 by default),
+        for example:
+
+        ./checkAdaptive 100000 40
+
+    Each pair has lengths picked separately, so most pairs differ in
+        length, and values that are either small whole numbers, giving many
+        equally cheap paths, or uniform in [0, 1). solveProblemDAdaptive is
+        given a random starting window, cost and step pattern, and its
+        distance is checked against solveProblemADistance's. The number of
+        pairs whose distances differ is printed, each with its sequences.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "problem.h"
+
+#define PAIRS_ARG 1
+#define LENGTH_ARG 2
+#define NUMBER_BASE (10)
+
+#define DEFAULT_PAIRS 20000
+#define DEFAULT_LENGTH 30
+
+/* Whole number values run from 0 up to this. */
+#define LARGEST_WHOLE_VALUE 4
+
+/* Fills seq with length random values, whole numbers if whole is 1. */
+void randomSequence(long double *seq, int length, int whole);
+
+/* Prints the given sequence to stderr in the text format. */
+void printSequence(const char *name, long double *seq, int length);
+
+int main(int argc, char **argv){
+    int pairCount = DEFAULT_PAIRS;
+    int length = DEFAULT_LENGTH;
+    if(argc > PAIRS_ARG){
+        pairCount = strtol(argv[PAIRS_ARG], NULL, NUMBER_BASE);
+    }
+    if(argc > LENGTH_ARG){
+        length = strtol(argv[LENGTH_ARG], NULL, NUMBER_BASE);
+    }
+    if(pairCount < 1 || length < 1){
+        fprintf(stderr, "Run the program in the form \n"
+            "\t./checkAdaptive [pairs [length]]\n");
+        return EXIT_FAILURE;
+    }
+
+    long double *seqA = (long double *) malloc(sizeof(long double) * length);
+    assert(seqA);
+    long double *seqB = (long double *) malloc(sizeof(long double) * length);
+    assert(seqB);
+    enum dtwCost costs[] = {COST_ABSOLUTE, COST_SQUARED};
+    enum stepPattern steps[] = {STEP_SYMMETRIC1, STEP_SYMMETRIC2,
+        STEP_WEIGHTED_DIAGONAL};
+    long double weights[] = {0.5, 1.5};
+
+    srand(20007);
+    int mismatches = 0;
+    for(int pair = 0; pair < pairCount; pair++){
+        int n = 1 + rand() % length;
+        int m = 1 + rand() % length;
+        int whole = rand() % 2;
+        randomSequence(seqA, n, whole);
+        randomSequence(seqB, m, whole);
+        int windowSize = rand() % length;
+        enum dtwCost cost = costs[rand() % 2];
+        enum stepPattern step = steps[rand() % 3];
+        long double weight = weights[rand() % 2];
+
+        struct problem *exact = newProblemA(seqA, n, seqB, m);
+        setProblemCost(exact, cost);
+        setProblemStepPattern(exact, step, weight);
+        struct solution *exactSolution = solveProblemADistance(exact);
+        struct problem *adaptive = newProblemD(seqA, n, seqB, m, windowSize);
+        setProblemCost(adaptive, cost);
+        setProblemStepPattern(adaptive, step, weight);
+        struct solution *adaptiveSolution = solveProblemDAdaptive(adaptive);
+
+        if(getOptimalValue(adaptiveSolution) !=
+            getOptimalValue(exactSolution)){
+            fprintf(stderr, "Window %d gave %.2Lf, not %.2Lf, for\n",
+                windowSize, getOptimalValue(adaptiveSolution),
+                getOptimalValue(exactSolution));
+            printSequence("seqA", seqA, n);
+            printSequence("seqB", seqB, m);
+            mismatches++;
+        }
+        freeSolution(adaptiveSolution, adaptive);
+        freeProblem(adaptive);
+        freeSolution(exactSolution, exact);
+        freeProblem(exact);
+    }
+    free(seqA);
+    free(seqB);
+
+    printf("%d pairs, %d distances differ\n", pairCount, mismatches);
+
+    return mismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+void randomSequence(long double *seq, int length, int whole){
+    for(int i = 0; i < length; i++){
+        if(whole){
+            seq[i] = rand() % (LARGEST_WHOLE_VALUE + 1);
+        } else {
+            seq[i] = (long double) rand() / RAND_MAX;
+        }
+    }
+}
+
+void printSequence(const char *name, long double *seq, int length){
+    fprintf(stderr, "    %s ", name);
+    for(int i = 0; i < length; i++){
+        fprintf(stderr, "%s%.21LE", (i == 0) ? "" : ", ", seq[i]);
+    }
+    fprintf(stderr, "\n");
+}
@@ -0,0 +1,125 @@
+/*
+    Make using
+        make convertSequence
+
+    Run using
+        ./convertSequence input output format
+
+    where input is a sequence file in either the text or binary format,
+        output is the file to write and format is the format to write it
+        in, one of
+            text        comma-separated text, as in test_cases
+            float       binary, 4-byte floats
+            double      binary, 8-byte doubles
+            longdouble  binary, long doubles, which are read without
+                        copying
+        for example:
+
+        ./convertSequence test_cases/1a-1-seqA.txt 1a-1-seqA.bin longdouble
+        ./convertSequence 1a-1-seqA.bin 1a-1-seqA.txt text
+
+    Text written from a binary file has enough digits to give back the same
+        values as the binary file. Multivariate sequences keep their values
+        per step.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sequenceFile.h"
+
+#define INPUT_ARG 1
+#define OUTPUT_ARG 2
+#define FORMAT_ARG 3
+
+#define TEXT_FORMAT "text"
+#define FLOAT_FORMAT "float"
+#define DOUBLE_FORMAT "double"
+#define LONG_DOUBLE_FORMAT "longdouble"
+
+/*
+    Returns the element type of the given binary sequence file, or
+    SEQUENCE_LONG_DOUBLE for a text file, which is read as long doubles.
+*/
+enum sequenceElementType inputElementType(char *fileName);
+
+int main(int argc, char **argv){
+    if(argc < 4){
+        fprintf(stderr, "You only gave %d arguments to the program, \n"
+            "you should run the program with in the form \n"
+            "\t./convertSequence input output "
+            "text|float|double|longdouble\n", argc);
+        return EXIT_FAILURE;
+    }
+
+    int toText = 0;
+    enum sequenceElementType outputType;
+    if(strcmp(argv[FORMAT_ARG], TEXT_FORMAT) == 0){
+        toText = 1;
+        outputType = inputElementType(argv[INPUT_ARG]);
+    } else if(strcmp(argv[FORMAT_ARG], FLOAT_FORMAT) == 0){
+        outputType = SEQUENCE_FLOAT;
+    } else if(strcmp(argv[FORMAT_ARG], DOUBLE_FORMAT) == 0){
+        outputType = SEQUENCE_DOUBLE;
+    } else if(strcmp(argv[FORMAT_ARG], LONG_DOUBLE_FORMAT) == 0){
+        outputType = SEQUENCE_LONG_DOUBLE;
+    } else {
+        fprintf(stderr, "Unrecognised format \"%s\"\n", argv[FORMAT_ARG]);
+        return EXIT_FAILURE;
+    }
+
+    FILE *inputFile = fopen(argv[INPUT_ARG], "rb");
+    if(! inputFile){
+        fprintf(stderr, "File given as input file was \"%s\", "
+            "which was unable to be opened\n", argv[INPUT_ARG]);
+        perror("Reason for file open failure");
+        return EXIT_FAILURE;
+    }
+    int seqLength = 0;
+    int dimensions = 1;
+    long double *seq = NULL;
+    struct sequenceMapping *mapping = loadMultivariateSequence(inputFile,
+        &seqLength, &dimensions, &seq);
+    fclose(inputFile);
+
+    FILE *outputFile = fopen(argv[OUTPUT_ARG], toText ? "w" : "wb");
+    if(! outputFile){
+        fprintf(stderr, "File given as output file was \"%s\", "
+            "which was unable to be opened\n", argv[OUTPUT_ARG]);
+        perror("Reason for file open failure");
+        return EXIT_FAILURE;
+    }
+    if(toText){
+        writeTextSequence(outputFile, seq, seqLength, dimensions, outputType);
+    } else {
+        writeBinarySequence(outputFile, seq, seqLength, dimensions,
+            outputType);
+    }
+    if(fclose(outputFile) != 0){
+        perror("Encountered error writing output file");
+        return EXIT_FAILURE;
+    }
+
+    if(mapping){
+        freeSequenceMapping(mapping);
+    } else {
+        free(seq);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+enum sequenceElementType inputElementType(char *fileName){
+    enum sequenceElementType elementType = SEQUENCE_LONG_DOUBLE;
+    FILE *inputFile = fopen(fileName, "rb");
+    if(! inputFile){
+        return elementType;
+    }
+    struct sequenceFileHeader header;
+    if(fread(&header, sizeof(struct sequenceFileHeader), 1, inputFile) == 1 &&
+        memcmp(header.magic, SEQUENCE_FILE_MAGIC, SEQUENCE_FILE_MAGIC_SIZE)
+        == 0){
+        elementType = header.elementType;
+    }
+    fclose(inputFile);
+    return elementType;
+}
@@ -0,0 +1,277 @@
+/*
+    Implementation for module which holds the scalar long double DTW
+        recurrence.
+
+    Each cost source is a pair of macros, ROW_COSTS_<NAME> run once per row
+        and CELL_COST_<NAME> giving the cost of cell (i, j) in that row, and
+        each step pattern is a macro STEP_<NAME> combining a cell's cost
+        with its up, left and diagonal neighbours:
+
+            symmetric1  c + min(up, left, diag)
+            weighted    min(c + min(up, left), weight * c + diag)
+            symmetric2  min(c + min(up, left), 2 * c + diag)
+
+    The fill and layer row functions are defined once for every cost source
+        and step pattern by DEFINE_DTW_FILL, DEFINE_RANGE_FILL and
+        DEFINE_LAYER_ROW, and the right one is looked up in a table before
+        any cells are computed.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include "problem.h"
+#include "dtwCore.h"
+
+/* Cost sources, the two public cost functions and costs from rowCosts, 
+    which ignore the value of seqA. */
+#define COST_SOURCE_COUNT 3
+#define COST_SUPPLIED 2
+#define STEP_PATTERN_COUNT 3
+
+#define ROW_COSTS_Absolute(r, i, jStart, jEnd)
+#define CELL_COST_Absolute(r, x, seqB, j) fabsl((x) - (seqB)[(j) - 1])
+
+#define ROW_COSTS_Squared(r, i, jStart, jEnd)
+#define CELL_COST_Squared(r, x, seqB, j) \
+    (((x) - (seqB)[(j) - 1]) * ((x) - (seqB)[(j) - 1]))
+
+#define ROW_COSTS_Supplied(r, i, jStart, jEnd) \
+    (r)->rowCosts((r)->context, (i), (jStart), (jEnd), (r)->costRow)
+#define CELL_COST_Supplied(r, x, seqB, j) ((r)->costRow[(j)])
+
+#define STEP_Symmetric1(r, c, up, left, diag) \
+    ((c) + fminl((up), fminl((left), (diag))))
+#define STEP_Weighted(r, c, up, left, diag) \
+    fminl((c) + fminl((up), (left)), (r)->diagonalWeight * (c) + (diag))
+#define STEP_Symmetric2(r, c, up, left, diag) \
+    fminl((c) + fminl((up), (left)), 2 * (c) + (diag))
+
+typedef int (*dtwFill)(struct dtwRecurrence *r, long double *seqA, int n,
+    long double *seqB, int m, int windowSize, long double threshold,
+    long double **rows, int rowCount, int *rowStart);
+
+typedef int (*rangeFill)(struct dtwRecurrence *r, long double *seqA, int n,
+    long double *seqB, int m, int *lo, int *hi, size_t *offset,
+    long double *cells, long double *above, long double threshold);
+
+typedef void (*layerRow)(struct dtwRecurrence *r, long double *seqA,
+    long double *seqB, int i, int jStart, int jEnd, long double *row,
+    long double *above, long double *same);
+
+/*
+    Defines dtwFill<COST><STEP><WINDOWED>. Without a window, every row runs
+    from column 1 to m, so the window bounds are never computed.
+*/
+#define DEFINE_DTW_FILL(COST, STEP, WINDOWED)                                  \
+static int dtwFill##COST##STEP##WINDOWED(struct dtwRecurrence *r,              \
+    long double *seqA, int n, long double *seqB, int m, int windowSize,        \
+    long double threshold, long double **rows, int rowCount,                   \
+    int *rowStart){                                                            \
+    int i, j;                                                                  \
+    for(i = 1; i <= n; i++){                                                   \
+        int jStart = 1;                                                        \
+        int jEnd = m;                                                          \
+        if(WINDOWED){                                                          \
+            jStart = (i - windowSize > 1) ? (i - windowSize) : 1;              \
+            jEnd = (i + windowSize < m) ? (i + windowSize) : m;                \
+        }                                                                      \
+        int start = rowStart ? rowStart[i] : 0;                                \
+        int aboveStart = rowStart ? rowStart[i - 1] : 0;                       \
+        long double *row = rows[i % rowCount];                                 \
+        long double *above = rows[(i - 1) % rowCount];                         \
+        long double x = seqA[i - 1];                                           \
+        (void) x;                                                              \
+        long double rowMin = LDINFINITY;                                       \
+        /* Column 0, or the cell before the window, which may be stale */      \
+        /* in two rolling rows. */                                             \
+        if(jStart <= jEnd + 1){                                                \
+            row[jStart - 1 - start] = LDINFINITY;                              \
+        }                                                                      \
+        ROW_COSTS_##COST(r, i, jStart, jEnd);                                  \
+        for(j = jStart; j <= jEnd; j++){                                       \
+            long double cost = CELL_COST_##COST(r, x, seqB, j);                \
+            long double cell = STEP_##STEP(r, cost, above[j - aboveStart],     \
+                row[j - 1 - start], above[j - 1 - aboveStart]);                \
+            row[j - start] = cell;                                             \
+            if(cell < rowMin){                                                 \
+                rowMin = cell;                                                 \
+            }                                                                  \
+        }                                                                      \
+        if(rowMin > threshold){                                                \
+            return i;                                                          \
+        }                                                                      \
+    }                                                                          \
+    return 0;                                                                  \
+}
+
+/*
+    Sets above[j] to cell (i, j) of the given row for columns first to last,
+    where the row holds columns rowLo to rowHi and every other cell is 
+    infinite.
+*/
+static void spreadRow(long double *above, int first, int last, 
+    long double *row, int rowLo, int rowHi);
+
+static void spreadRow(long double *above, int first, int last, 
+    long double *row, int rowLo, int rowHi){
+    int copyFirst = (rowLo > first) ? rowLo : first;
+    int copyLast = (rowHi < last) ? rowHi : last;
+    if(copyFirst > copyLast){
+        /* Nothing to copy. */
+        copyFirst = last + 1;
+        copyLast = last;
+    }
+    int j;
+    for(j = first; j < copyFirst; j++){
+        above[j] = LDINFINITY;
+    }
+    for(j = copyFirst; j <= copyLast; j++){
+        above[j] = row[j - rowLo];
+    }
+    for(j = copyLast + 1; j <= last; j++){
+        above[j] = LDINFINITY;
+    }
+}
+
+/*
+    Defines rangeFill<COST><STEP>. Each row's neighbours above are spread 
+    out by column first, so the inner loop is the same as the windowed one,
+    with the cell to the left kept in a local.
+*/
+#define DEFINE_RANGE_FILL(COST, STEP)                                          \
+static int rangeFill##COST##STEP(struct dtwRecurrence *r, long double *seqA,   \
+    int n, long double *seqB, int m, int *lo, int *hi, size_t *offset,         \
+    long double *cells, long double *above, long double threshold){            \
+    int i, j;                                                                  \
+    (void) m;                                                                  \
+    for(i = 1; i <= n; i++){                                                   \
+        int jStart = lo[i];                                                    \
+        int jEnd = hi[i];                                                      \
+        long double *row = cells + offset[i];                                  \
+        long double x = seqA[i - 1];                                           \
+        (void) x;                                                              \
+        long double rowMin = LDINFINITY;                                       \
+        if(jStart <= jEnd){                                                    \
+            spreadRow(above, jStart - 1, jEnd, cells + offset[i - 1],          \
+                lo[i - 1], hi[i - 1]);                                         \
+            ROW_COSTS_##COST(r, i, jStart, jEnd);                              \
+            long double left = LDINFINITY;                                     \
+            for(j = jStart; j <= jEnd; j++){                                   \
+                long double cost = CELL_COST_##COST(r, x, seqB, j);            \
+                long double cell = STEP_##STEP(r, cost, above[j], left,        \
+                    above[j - 1]);                                             \
+                row[j - jStart] = cell;                                        \
+                left = cell;                                                   \
+                if(cell < rowMin){                                             \
+                    rowMin = cell;                                             \
+                }                                                              \
+            }                                                                  \
+        }                                                                      \
+        if(rowMin > threshold){                                                \
+            return i;                                                          \
+        }                                                                      \
+    }                                                                          \
+    return 0;                                                                  \
+}
+
+/* Defines layerRow<COST><STEP>. */
+#define DEFINE_LAYER_ROW(COST, STEP)                                           \
+static void layerRow##COST##STEP(struct dtwRecurrence *r, long double *seqA,   \
+    long double *seqB, int i, int jStart, int jEnd, long double *row,          \
+    long double *above, long double *same){                                    \
+    long double x = seqA[i - 1];                                               \
+    (void) x;                                                                  \
+    ROW_COSTS_##COST(r, i, jStart, jEnd);                                      \
+    for(int j = jStart; j <= jEnd; j++){                                       \
+        long double cost = CELL_COST_##COST(r, x, seqB, j);                    \
+        row[j] = STEP_##STEP(r, cost, above[j], same[j - 1], above[j - 1]);    \
+    }                                                                          \
+}
+
+/* Defines every variant for one cost source and step pattern. */
+#define DEFINE_DTW_VARIANTS(COST, STEP)                                        \
+    DEFINE_DTW_FILL(COST, STEP, 0)                                             \
+    DEFINE_DTW_FILL(COST, STEP, 1)                                             \
+    DEFINE_RANGE_FILL(COST, STEP)                                              \
+    DEFINE_LAYER_ROW(COST, STEP)
+
+DEFINE_DTW_VARIANTS(Absolute, Symmetric1)
+DEFINE_DTW_VARIANTS(Absolute, Weighted)
+DEFINE_DTW_VARIANTS(Absolute, Symmetric2)
+DEFINE_DTW_VARIANTS(Squared, Symmetric1)
+DEFINE_DTW_VARIANTS(Squared, Weighted)
+DEFINE_DTW_VARIANTS(Squared, Symmetric2)
+DEFINE_DTW_VARIANTS(Supplied, Symmetric1)
+DEFINE_DTW_VARIANTS(Supplied, Weighted)
+DEFINE_DTW_VARIANTS(Supplied, Symmetric2)
+
+/* Indexed by cost source, step pattern and whether windowed. */
+static const dtwFill fills[COST_SOURCE_COUNT][STEP_PATTERN_COUNT][2] = {
+    {{dtwFillAbsoluteSymmetric10, dtwFillAbsoluteSymmetric11},
+        {dtwFillAbsoluteWeighted0, dtwFillAbsoluteWeighted1},
+        {dtwFillAbsoluteSymmetric20, dtwFillAbsoluteSymmetric21}},
+    {{dtwFillSquaredSymmetric10, dtwFillSquaredSymmetric11},
+        {dtwFillSquaredWeighted0, dtwFillSquaredWeighted1},
+        {dtwFillSquaredSymmetric20, dtwFillSquaredSymmetric21}},
+    {{dtwFillSuppliedSymmetric10, dtwFillSuppliedSymmetric11},
+        {dtwFillSuppliedWeighted0, dtwFillSuppliedWeighted1},
+        {dtwFillSuppliedSymmetric20, dtwFillSuppliedSymmetric21}}
+};
+
+/* Indexed by cost source and step pattern. */
+static const rangeFill rangeFills[COST_SOURCE_COUNT][STEP_PATTERN_COUNT] = {
+    {rangeFillAbsoluteSymmetric1, rangeFillAbsoluteWeighted,
+        rangeFillAbsoluteSymmetric2},
+    {rangeFillSquaredSymmetric1, rangeFillSquaredWeighted,
+        rangeFillSquaredSymmetric2},
+    {rangeFillSuppliedSymmetric1, rangeFillSuppliedWeighted,
+        rangeFillSuppliedSymmetric2}
+};
+
+/* Indexed by cost source and step pattern. */
+static const layerRow layerRows[COST_SOURCE_COUNT][STEP_PATTERN_COUNT] = {
+    {layerRowAbsoluteSymmetric1, layerRowAbsoluteWeighted,
+        layerRowAbsoluteSymmetric2},
+    {layerRowSquaredSymmetric1, layerRowSquaredWeighted,
+        layerRowSquaredSymmetric2},
+    {layerRowSuppliedSymmetric1, layerRowSuppliedWeighted,
+        layerRowSuppliedSymmetric2}
+};
+
+/* Returns the cost source index of the recurrence. */
+static int costSource(struct dtwRecurrence *r);
+
+static int costSource(struct dtwRecurrence *r){
+    if(r->rowCosts){
+        assert(r->costRow);
+        return COST_SUPPLIED;
+    }
+    assert(r->cost == COST_ABSOLUTE || r->cost == COST_SQUARED);
+    return (int) r->cost;
+}
+
+int dtwCoreFill(struct dtwRecurrence *r, long double *seqA, int n,
+    long double *seqB, int m, int windowSize, long double threshold,
+    long double **rows, int rowCount, int *rowStart){
+    assert(r->step >= 0 && r->step < STEP_PATTERN_COUNT);
+    int windowed = (windowSize < n || windowSize < m);
+    return fills[costSource(r)][r->step][windowed](r, seqA, n, seqB, m,
+        windowSize, threshold, rows, rowCount, rowStart);
+}
+
+int dtwCoreFillRanges(struct dtwRecurrence *r, long double *seqA, int n,
+    long double *seqB, int m, int *lo, int *hi, size_t *offset,
+    long double *cells, long double *above, long double threshold){
+    assert(r->step >= 0 && r->step < STEP_PATTERN_COUNT);
+    return rangeFills[costSource(r)][r->step](r, seqA, n, seqB, m, lo, hi,
+        offset, cells, above, threshold);
+}
+
+void dtwCoreLayerRow(struct dtwRecurrence *r, long double *seqA,
+    long double *seqB, int i, int jStart, int jEnd, long double *row,
+    long double *above, long double *same){
+    assert(r->step >= 0 && r->step < STEP_PATTERN_COUNT);
+    layerRows[costSource(r)][r->step](r, seqA, seqB, i, jStart, jEnd, row,
+        above, same);
+}
@@ -0,0 +1,68 @@
+/*
+    Header for module which holds the scalar long double DTW recurrence,
+        generated once per combination of cost function, step pattern and
+        window constraint, so every variant's inner loop is free of
+        per-cell switches.
+*/
+
+#ifndef DTWCORE_H
+#define DTWCORE_H
+
+#include "problem.h"
+
+/* Which recurrence a core computes, and the values it needs. */
+struct dtwRecurrence {
+    enum dtwCost cost;
+    enum stepPattern step;
+    /* For STEP_WEIGHTED_DIAGONAL, what the diagonal step's cost is
+        multiplied by. */
+    long double diagonalWeight;
+    /* If set, used instead of cost to set costRow[j] to the cost of cell
+        (i, j) for j from jFirst to jLast, once per row (as for
+        multivariate sequences). costRow must hold m + 1 cells. */
+    void (*rowCosts)(void *context, int i, int jFirst, int jLast,
+        long double *cost);
+    void *context;
+    long double *costRow;
+};
+
+/*
+    Fills in rows 1 to n of the DTW matrix between seqA (length n) and seqB
+    (length m) with the given recurrence, only visiting cells where
+    |i - j| <= windowSize, cell (i, j) being 
+    rows[i % rowCount][j - rowStart[i]] (or rows[i % rowCount][j] if 
+    rowStart is NULL). Pass a windowSize of at least max(n, m) for an 
+    unconstrained DTW, and a rowCount of n + 1 to keep every row or 2 to 
+    only keep two rolling rows. Row 0 must already be set, and with a 
+    window, so must the cells just after it (as the guard cells of a band 
+    are, or as row 0 of rolling rows is). The cell just before each row's 
+    window, column 0 without one, is set to infinity.
+
+    Stops after the first row whose every cell exceeds threshold, returning
+    that row. Returns 0 if every row was filled in.
+*/
+int dtwCoreFill(struct dtwRecurrence *r, long double *seqA, int n,
+    long double *seqB, int m, int windowSize, long double threshold,
+    long double **rows, int rowCount, int *rowStart);
+
+/*
+    Same as dtwCoreFill, but only visiting columns lo[i] to hi[i] of each
+    row i, where an empty row has hi[i] < lo[i] (see rowRanges.h). Cell
+    (i, j) is cells[offset[i] + j - lo[i]], and cells outside every row's
+    range are taken as infinite. Row 0 must already be set. above must hold
+    m + 1 cells, into which each row's previous row is spread out by column.
+*/
+int dtwCoreFillRanges(struct dtwRecurrence *r, long double *seqA, int n,
+    long double *seqB, int m, int *lo, int *hi, size_t *offset,
+    long double *cells, long double *above, long double threshold);
+
+/*
+    Computes row i of a Part F layer from columns jStart to jEnd, where
+    above and same are rows i - 1 and i of the layer before, all indexed
+    by column.
+*/
+void dtwCoreLayerRow(struct dtwRecurrence *r, long double *seqA,
+    long double *seqB, int i, int jStart, int jEnd, long double *row,
+    long double *above, long double *same);
+
+#endif
@@ -0,0 +1,215 @@
+/*
+    Implementation for module which approximates DTW in roughly linear
+        time, in the manner of FastDTW.
+
+    At each resolution the matrix is only computed within a window of
+        columns lo[i] to hi[i] for each row i, stored row after row like
+        the Part D band, except that rows are of varying width. Projecting
+        a warping path keeps both lo and hi non-decreasing, so the cells
+        within radius rows of row i span columns lo[i - radius] to
+        hi[i + radius].
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include "problem.h"
+#include "fastDTW.h"
+
+/* The DTW matrix of one resolution, within its window. */
+struct windowedMatrix {
+    int n;
+    int m;
+    /* Columns lo[i] to hi[i] of row i, for rows 1 to n, are stored. */
+    int *lo;
+    int *hi;
+    /* Row i starts at cells[offset[i]]. */
+    long long *offset;
+    long double *cells;
+};
+
+/* Returns cell (i, j), infinite outside the window. Cell (0, 0) is 0. */
+static inline long double windowCell(struct windowedMatrix *w, int i, int j);
+
+/*
+    Computes the DTW matrix of seqA and seqB within the window, and writes
+    an optimal path through it to pathI and pathJ, returning its cost.
+*/
+static long double windowedDTW(long double *seqA, int n, long double *seqB,
+    int m, int *lo, int *hi, int *pathI, int *pathJ, int *pathLength,
+    long long *cellsComputed);
+
+/* Averages each pair of values of seq into coarse, of length
+    (length + 1) / 2. */
+static void coarsen(long double *seq, int length, long double *coarse);
+
+static inline long double windowCell(struct windowedMatrix *w, int i, int j){
+    if(i == 0 || j == 0){
+        return (i == 0 && j == 0) ? 0 : LDINFINITY;
+    }
+    if(j < w->lo[i] || j > w->hi[i]){
+        return LDINFINITY;
+    }
+    return w->cells[w->offset[i] + (j - w->lo[i])];
+}
+
+static long double windowedDTW(long double *seqA, int n, long double *seqB,
+    int m, int *lo, int *hi, int *pathI, int *pathJ, int *pathLength,
+    long long *cellsComputed){
+    struct windowedMatrix w;
+    w.n = n;
+    w.m = m;
+    w.lo = lo;
+    w.hi = hi;
+    w.offset = (long long *) malloc(sizeof(long long) * (n + 2));
+    assert(w.offset);
+    w.offset[1] = 0;
+    for(int i = 1; i <= n; i++){
+        w.offset[i + 1] = w.offset[i] + (hi[i] - lo[i] + 1);
+    }
+    w.cells = (long double *) malloc(sizeof(long double) * w.offset[n + 1]);
+    assert(w.cells);
+    *cellsComputed += w.offset[n + 1];
+
+    long double cost;
+    for(int i = 1; i <= n; i++){
+        long double *row = &(w.cells[w.offset[i] - lo[i]]);
+        for(int j = lo[i]; j <= hi[i]; j++){
+            cost = fabsl(seqA[i-1] - seqB[j-1]);
+            row[j] = cost + fminl(windowCell(&w, i-1, j),
+                fminl(windowCell(&w, i, j-1), windowCell(&w, i-1, j-1)));
+        }
+    }
+    long double distance = windowCell(&w, n, m);
+
+    /* Walk back from (n, m), preferring diagonal steps on ties, then put
+        the path in order. */
+    int length = 0;
+    int i = n;
+    int j = m;
+    while(1){
+        pathI[length] = i;
+        pathJ[length] = j;
+        length++;
+        if(i == 1 && j == 1){
+            break;
+        }
+        long double diagonal = windowCell(&w, i-1, j-1);
+        long double up = windowCell(&w, i-1, j);
+        long double left = windowCell(&w, i, j-1);
+        if(i > 1 && j > 1 && diagonal <= up && diagonal <= left){
+            i--;
+            j--;
+        } else if(j == 1 || (i > 1 && up <= left)){
+            i--;
+        } else {
+            j--;
+        }
+    }
+    for(int k = 0; k < length / 2; k++){
+        int swapI = pathI[k];
+        int swapJ = pathJ[k];
+        pathI[k] = pathI[length - 1 - k];
+        pathJ[k] = pathJ[length - 1 - k];
+        pathI[length - 1 - k] = swapI;
+        pathJ[length - 1 - k] = swapJ;
+    }
+    *pathLength = length;
+
+    free(w.offset);
+    free(w.cells);
+
+    return distance;
+}
+
+static void coarsen(long double *seq, int length, long double *coarse){
+    for(int i = 0; i < length / 2; i++){
+        coarse[i] = (seq[2 * i] + seq[2 * i + 1]) / 2;
+    }
+    if(length % 2 == 1){
+        coarse[length / 2] = seq[length - 1];
+    }
+}
+
+long double fastDTW(long double *seqA, int n, long double *seqB, int m,
+    int radius, int *pathI, int *pathJ, int *pathLength,
+    long long *cellsComputed){
+    if(radius < 0){
+        radius = 0;
+    }
+    int *lo = (int *) malloc(sizeof(int) * (n + 1));
+    assert(lo);
+    int *hi = (int *) malloc(sizeof(int) * (n + 1));
+    assert(hi);
+
+    if(n <= radius + 2 || m <= radius + 2){
+        /* Short enough to solve exactly, over the whole matrix. */
+        for(int i = 1; i <= n; i++){
+            lo[i] = 1;
+            hi[i] = m;
+        }
+    } else {
+        /* Solve at half the resolution. */
+        int coarseN = (n + 1) / 2;
+        int coarseM = (m + 1) / 2;
+        long double *coarseA = (long double *) malloc(sizeof(long double) *
+            coarseN);
+        assert(coarseA);
+        long double *coarseB = (long double *) malloc(sizeof(long double) *
+            coarseM);
+        assert(coarseB);
+        coarsen(seqA, n, coarseA);
+        coarsen(seqB, m, coarseB);
+        int *coarseI = (int *) malloc(sizeof(int) * (coarseN + coarseM - 1));
+        assert(coarseI);
+        int *coarseJ = (int *) malloc(sizeof(int) * (coarseN + coarseM - 1));
+        assert(coarseJ);
+        int coarseLength;
+        fastDTW(coarseA, coarseN, coarseB, coarseM, radius, coarseI, coarseJ,
+            &coarseLength, cellsComputed);
+
+        /* Each coarse cell covers a 2 x 2 block of cells at this
+            resolution. */
+        for(int i = 1; i <= n; i++){
+            lo[i] = m;
+            hi[i] = 1;
+        }
+        for(int k = 0; k < coarseLength; k++){
+            for(int i = 2 * coarseI[k] - 1; i <= 2 * coarseI[k] && i <= n; i++){
+                int first = 2 * coarseJ[k] - 1;
+                int last = (2 * coarseJ[k] <= m) ? 2 * coarseJ[k] : m;
+                if(first < lo[i]){
+                    lo[i] = first;
+                }
+                if(last > hi[i]){
+                    hi[i] = last;
+                }
+            }
+        }
+
+        /* Widen by radius in every direction. lo and hi are non-decreasing,
+            so hi is widened from the first row and lo from the last, each
+            only reading rows not yet widened. */
+        for(int i = 1; i <= n; i++){
+            int below = (i + radius < n) ? i + radius : n;
+            hi[i] = (hi[below] + radius < m) ? hi[below] + radius : m;
+        }
+        for(int i = n; i >= 1; i--){
+            int above = (i - radius > 1) ? i - radius : 1;
+            lo[i] = (lo[above] - radius > 1) ? lo[above] - radius : 1;
+        }
+
+        free(coarseA);
+        free(coarseB);
+        free(coarseI);
+        free(coarseJ);
+    }
+
+    long double distance = windowedDTW(seqA, n, seqB, m, lo, hi, pathI,
+        pathJ, pathLength, cellsComputed);
+
+    free(lo);
+    free(hi);
+
+    return distance;
+}
@@ -0,0 +1,31 @@
+/*
+    Header for module which approximates DTW in roughly linear time, in
+        the manner of FastDTW (Salvador and Chan).
+
+    Both sequences are halved in resolution by averaging neighbouring
+        values until they are short, solved exactly there, and the warping
+        path found is projected back up one resolution at a time. Each
+        finer resolution is only solved within radius cells of the
+        projected path, so the result is the cost of a real warping path,
+        but not necessarily the cheapest one.
+*/
+
+#ifndef FASTDTW_H
+#define FASTDTW_H
+
+/*
+    Approximates the DTW cost between seqA (length n) and seqB (length m),
+    refining within the given radius of each projected path. Larger radii
+    are slower but closer to the exact cost.
+
+    The warping path the cost is for is written in order from (1, 1) to
+    (n, m) to pathI and pathJ, which must each have room for n + m - 1
+    cells, and pathLength is set to its number of cells. cellsComputed is
+    set to the number of matrix cells computed over all resolutions, to
+    compare against the n * m of the exact DTW.
+*/
+long double fastDTW(long double *seqA, int n, long double *seqB, int m,
+    int radius, int *pathI, int *pathJ, int *pathLength,
+    long long *cellsComputed);
+
+#endif
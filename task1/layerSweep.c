@@ -0,0 +1,235 @@
+/*
+    Implementation for module which computes Part F's path-length limited
+        DTW one layer at a time.
+
+    Layer k holds cells reachable in exactly k steps, i.e. those with
+        max(i, j) <= k < i + j, so row i of layer k runs from column
+        max(k - i + 1, 1) to min(k, m) and reads rows i - 1 and i of layer
+        k - 1. Cells no longer reachable are reset to infinity as the start
+        of each row moves left to right, as in solveProblemF, so every read
+        outside the reachable region sees infinity.
+
+    Rows are dealt out to threads in blocks of LAYER_ROW_BLOCK, round-robin,
+        so each thread gets a similar share of the short and long rows.
+        Row n always goes to the same thread, which keeps the running
+        minimum of cell (n, m).
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include <pthread.h>
+#include "problem.h"
+#include "simdKernel.h"
+#include "layerSweep.h"
+
+/* Everything shared by the threads working on one problem. */
+struct layerSweep {
+    /* The sequences, converted to the precision computed in. */
+    void *a;
+    void *b;
+    int n;
+    int m;
+    /* The last layer computed, and the first that can reach (n, m). */
+    int lastLayer;
+    int firstEndLayer;
+    int threadCount;
+    /* Two layers of (n + 1) rows of (m + 1) cells, used alternately. */
+    void *layers[2];
+    /* Where the layers and converted sequences come from, if anywhere. */
+    struct workspace *workspace;
+    pthread_barrier_t barrier;
+};
+
+/* One thread's share of the work. */
+struct layerThread {
+    struct layerSweep *s;
+    int threadIndex;
+    /* The cheapest cell (n, m) this thread found. */
+    long double minCost;
+};
+
+/* Computes one row of long double cells, with no vector kernel to use. */
+static void longDoubleRow(long double *out, long double x,
+    const long double *y, const long double *up, const long double *left,
+    const long double *diag, int count);
+
+static void longDoubleRow(long double *out, long double x,
+    const long double *y, const long double *up, const long double *left,
+    const long double *diag, int count){
+    for(int k = 0; k < count; k++){
+        out[k] = fabsl(x - y[k]) + fminl(up[k], fminl(left[k], diag[k]));
+    }
+}
+
+/*
+    Defines layerWorker<SUFFIX>, one thread's sweep over the layers in the
+    given type, where ROW computes a row of cells and INF is the type's
+    infinity.
+*/
+#define DEFINE_LAYER_WORKER(TYPE, SUFFIX, ROW, INF)                            \
+static void *layerWorker##SUFFIX(void *arg){                                   \
+    struct layerThread *thread = (struct layerThread *) arg;                   \
+    struct layerSweep *s = thread->s;                                          \
+    TYPE *a = (TYPE *) s->a;                                                   \
+    TYPE *b = (TYPE *) s->b;                                                   \
+    int n = s->n;                                                              \
+    int m = s->m;                                                              \
+    size_t stride = (size_t) m + 1;                                            \
+    int lastBlock = (n - 1) / LAYER_ROW_BLOCK;                                 \
+    int ownsLastRow = (lastBlock % s->threadCount == thread->threadIndex);     \
+                                                                               \
+    for(int k = 1; k <= s->lastLayer; k++){                                    \
+        TYPE *current = (TYPE *) s->layers[k % 2];                             \
+        TYPE *previous = (TYPE *) s->layers[(k - 1) % 2];                      \
+        int iEnd = (k < n) ? k : n;                                            \
+        int jEnd = (k < m) ? k : m;                                            \
+        for(int block = thread->threadIndex;                                   \
+            block * LAYER_ROW_BLOCK < iEnd; block += s->threadCount){          \
+            int iStart = 1 + block * LAYER_ROW_BLOCK;                          \
+            int iLast = iStart + LAYER_ROW_BLOCK - 1;                          \
+            if(iLast > iEnd){                                                  \
+                iLast = iEnd;                                                  \
+            }                                                                  \
+            for(int i = iStart; i <= iLast; i++){                              \
+                TYPE *row = current + i * stride;                              \
+                TYPE *above = previous + (i - 1) * stride;                     \
+                TYPE *same = previous + i * stride;                            \
+                int jStart = (k - i + 1 > 1) ? (k - i + 1) : 1;                \
+                /* Layer k - 2 also reached the two cells before jStart. */    \
+                int staleStart = (jStart - 2 > 1) ? (jStart - 2) : 1;          \
+                for(int j = staleStart; j < jStart && j <= m; j++){            \
+                    row[j] = INF;                                              \
+                }                                                              \
+                if(jStart <= jEnd){                                            \
+                    ROW(row + jStart, a[i - 1], b + jStart - 1,                \
+                        above + jStart, same + jStart - 1,                     \
+                        above + jStart - 1, jEnd - jStart + 1);                \
+                }                                                              \
+            }                                                                  \
+        }                                                                      \
+        if(ownsLastRow && k >= s->firstEndLayer &&                             \
+            (long double) current[n * stride + m] < thread->minCost){          \
+            thread->minCost = (long double) current[n * stride + m];           \
+        }                                                                      \
+        pthread_barrier_wait(&(s->barrier));                                   \
+    }                                                                          \
+                                                                               \
+    return NULL;                                                               \
+}
+
+DEFINE_LAYER_WORKER(long double, LongDouble, longDoubleRow, LDINFINITY)
+DEFINE_LAYER_WORKER(double, Double, simdRowDouble, (double) INFINITY)
+DEFINE_LAYER_WORKER(float, Float, simdRowFloat, (float) INFINITY)
+
+/*
+    Defines initialiseLayers<SUFFIX>, which allocates the converted
+    sequences and the two layers in the given type, every cell infinite
+    except (0, 0).
+*/
+#define DEFINE_INITIALISE_LAYERS(TYPE, SUFFIX, INF)                            \
+static void initialiseLayers##SUFFIX(struct layerSweep *s,                     \
+    long double *seqA, long double *seqB){                                     \
+    TYPE *a = (TYPE *) workspaceAlloc(s->workspace, sizeof(TYPE) * s->n);      \
+    for(int i = 0; i < s->n; i++){                                             \
+        a[i] = (TYPE) seqA[i];                                                 \
+    }                                                                          \
+    TYPE *b = (TYPE *) workspaceAlloc(s->workspace, sizeof(TYPE) * s->m);      \
+    for(int j = 0; j < s->m; j++){                                             \
+        b[j] = (TYPE) seqB[j];                                                 \
+    }                                                                          \
+    s->a = a;                                                                  \
+    s->b = b;                                                                  \
+    size_t cells = ((size_t) s->n + 1) * ((size_t) s->m + 1);                  \
+    for(int layer = 0; layer < 2; layer++){                                    \
+        TYPE *cell = (TYPE *) workspaceAlloc(s->workspace,                     \
+            sizeof(TYPE) * cells);                                             \
+        for(size_t c = 0; c < cells; c++){                                     \
+            cell[c] = INF;                                                     \
+        }                                                                      \
+        cell[0] = 0;                                                           \
+        s->layers[layer] = cell;                                               \
+    }                                                                          \
+}
+
+DEFINE_INITIALISE_LAYERS(long double, LongDouble, LDINFINITY)
+DEFINE_INITIALISE_LAYERS(double, Double, (double) INFINITY)
+DEFINE_INITIALISE_LAYERS(float, Float, (float) INFINITY)
+
+long double layerDTW(long double *seqA, int n, long double *seqB, int m,
+    int maxPathLength, int threadCount, enum dtwPrecision precision,
+    struct workspace *workspace){
+    struct layerSweep s;
+
+    assert(n > 0 && m > 0);
+    if(threadCount < 1){
+        threadCount = 1;
+    }
+    /* Cell (n, m) is only reachable once k is at least max(n, m). */
+    s.firstEndLayer = (n > m) ? n : m;
+    if(maxPathLength < s.firstEndLayer){
+        return LDINFINITY;
+    }
+    /* No cell is reachable in n + m or more steps, so stop before then. */
+    s.lastLayer = (maxPathLength < n + m - 1) ? maxPathLength : (n + m - 1);
+    s.n = n;
+    s.m = m;
+    s.threadCount = threadCount;
+    s.workspace = workspace;
+
+    void *(*worker)(void *) = NULL;
+    switch(precision){
+        case PRECISION_LONG_DOUBLE:
+            initialiseLayersLongDouble(&s, seqA, seqB);
+            worker = layerWorkerLongDouble;
+            break;
+        case PRECISION_DOUBLE:
+            initialiseLayersDouble(&s, seqA, seqB);
+            worker = layerWorkerDouble;
+            break;
+        case PRECISION_FLOAT:
+            initialiseLayersFloat(&s, seqA, seqB);
+            worker = layerWorkerFloat;
+            break;
+    }
+    assert(worker);
+
+    pthread_barrier_init(&(s.barrier), NULL, threadCount);
+    pthread_t *threads = (pthread_t *) workspaceAlloc(workspace, 
+        sizeof(pthread_t) * threadCount);
+    struct layerThread *threadArgs = (struct layerThread *)
+        workspaceAlloc(workspace, sizeof(struct layerThread) * threadCount);
+
+    /* The calling thread does the first share of the work itself. */
+    for(int t = 0; t < threadCount; t++){
+        threadArgs[t].s = &s;
+        threadArgs[t].threadIndex = t;
+        threadArgs[t].minCost = LDINFINITY;
+        if(t > 0){
+            int status = pthread_create(&threads[t], NULL, worker,
+                &threadArgs[t]);
+            assert(status == 0);
+        }
+    }
+    worker(&threadArgs[0]);
+    for(int t = 1; t < threadCount; t++){
+        pthread_join(threads[t], NULL);
+    }
+
+    long double minCost = LDINFINITY;
+    for(int t = 0; t < threadCount; t++){
+        if(threadArgs[t].minCost < minCost){
+            minCost = threadArgs[t].minCost;
+        }
+    }
+
+    pthread_barrier_destroy(&(s.barrier));
+    workspaceFree(workspace, threads);
+    workspaceFree(workspace, threadArgs);
+    workspaceFree(workspace, s.layers[0]);
+    workspaceFree(workspace, s.layers[1]);
+    workspaceFree(workspace, s.a);
+    workspaceFree(workspace, s.b);
+
+    return minCost;
+}
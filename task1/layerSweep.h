@@ -0,0 +1,35 @@
+/*
+    Header for module which computes Part F's path-length limited DTW one
+        layer at a time, sharing each layer's rows out among threads.
+
+    Every cell of layer k only depends on layer k - 1, so each row of a
+        layer is one element-wise vector kernel (see simdKernel.h) in double
+        or float, and the threads only wait for each other between layers.
+*/
+
+#ifndef LAYERSWEEP_H
+#define LAYERSWEEP_H
+
+#include "problem.h"
+#include "workspace.h"
+
+/* Rows of a layer dealt out to a thread at a time. */
+#define LAYER_ROW_BLOCK 16
+
+/*
+    Computes the minimum DTW cost between seqA (length n) and seqB (length
+    m) over warping paths of at most maxPathLength cells, using threadCount
+    threads, in the given precision. Long double rows are computed with
+    plain C, double and float rows with vector kernels. Returns LDINFINITY
+    if no such path exists.
+
+    Only the cells reachable in exactly k steps are visited in layer k, and
+    only two layers of at most (maxPathLength + 1)^2 cells are kept, taken 
+    from the workspace's arena (see workspace.h) if workspace is not NULL.
+    Starting the threads still allocates their own memory.
+*/
+long double layerDTW(long double *seqA, int n, long double *seqB, int m,
+    int maxPathLength, int threadCount, enum dtwPrecision precision,
+    struct workspace *workspace);
+
+#endif
@@ -0,0 +1,95 @@
+/*
+    Implementation for module which keeps the DTW distance between a fixed
+        template and a growing sequence.
+
+    The stream's values are the rows of the recurrence and the template's
+        the columns, so a batch of appended values is filled in by
+        dtwCoreFill as rows of two rolling rows, the first of which always
+        holds the last column of the DTW matrix between calls. Every step
+        pattern is symmetric, so this gives the same distance as solving
+        the template against the stream.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "problem.h"
+#include "dtwCore.h"
+#include "onlineDTW.h"
+
+struct onlineDTW {
+    long double *template;
+    int n;
+    /* Number of values appended so far. */
+    int length;
+    struct dtwRecurrence recurrence;
+    /* Two columns of n + 1 cells in one block, the first holding the last 
+        column. */
+    long double *cells;
+    long double *columns[2];
+};
+
+struct onlineDTW *newOnlineDTW(long double *template, int n,
+    enum dtwCost cost, enum stepPattern step, long double diagonalWeight){
+    assert(template && n > 0);
+    struct onlineDTW *o = (struct onlineDTW *) malloc(sizeof(struct onlineDTW));
+    assert(o);
+    o->template = template;
+    o->n = n;
+    o->length = 0;
+
+    o->recurrence.cost = cost;
+    o->recurrence.step = step;
+    o->recurrence.diagonalWeight = diagonalWeight;
+    o->recurrence.rowCosts = NULL;
+    o->recurrence.context = NULL;
+    o->recurrence.costRow = NULL;
+
+    o->cells = (long double *) malloc(sizeof(long double) * 2 * (n + 1));
+    assert(o->cells);
+    o->columns[0] = o->cells;
+    o->columns[1] = o->cells + (n + 1);
+
+    /* Column 0 of the DTW matrix */
+    o->columns[0][0] = 0;
+    for(int i = 1; i <= n; i++){
+        o->columns[0][i] = LDINFINITY;
+    }
+
+    return o;
+}
+
+void appendOnlineDTW(struct onlineDTW *o, long double *values, int count){
+    if(count <= 0){
+        return;
+    }
+    /* A window as long as both sides leaves every cell unconstrained. */
+    int unconstrained = (count > o->n) ? count : o->n;
+    dtwCoreFill(&(o->recurrence), values, count, o->template, o->n,
+        unconstrained, LDINFINITY, o->columns, 2, NULL);
+    /* The last column is in columns[count % 2], keep it first. */
+    if(count % 2){
+        long double *swap = o->columns[0];
+        o->columns[0] = o->columns[1];
+        o->columns[1] = swap;
+    }
+    o->length += count;
+}
+
+long double getOnlineDistance(struct onlineDTW *o){
+    if(o->length == 0){
+        return LDINFINITY;
+    }
+    return o->columns[0][o->n];
+}
+
+int getOnlineLength(struct onlineDTW *o){
+    return o->length;
+}
+
+void freeOnlineDTW(struct onlineDTW *o){
+    if(! o){
+        return;
+    }
+    free(o->cells);
+    free(o);
+}
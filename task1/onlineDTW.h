@@ -0,0 +1,41 @@
+/*
+    Header for module which keeps the DTW distance between a fixed template
+        and a sequence that grows over time, such as a live stream.
+
+    Only the last column of the DTW matrix (one cell per template value) is
+        kept, so each value appended costs one column of cells, O(n) time,
+        and memory stays linear in the template however long the stream.
+*/
+
+#ifndef ONLINEDTW_H
+#define ONLINEDTW_H
+
+#include "problem.h"
+
+struct onlineDTW;
+
+/*
+    Sets up an online DTW against the given template of n values, with the
+    given cost and step pattern (see setProblemCost and
+    setProblemStepPattern). The template is not copied, and must outlive
+    the online DTW. The stream starts empty.
+*/
+struct onlineDTW *newOnlineDTW(long double *template, int n,
+    enum dtwCost cost, enum stepPattern step, long double diagonalWeight);
+
+/* Appends count values to the stream, updating the DTW distance. */
+void appendOnlineDTW(struct onlineDTW *o, long double *values, int count);
+
+/*
+    Returns the DTW distance between the template and the whole stream so
+    far, LDINFINITY while the stream is empty.
+*/
+long double getOnlineDistance(struct onlineDTW *o);
+
+/* Returns the number of values appended to the stream so far. */
+int getOnlineLength(struct onlineDTW *o);
+
+/* Frees the online DTW and all memory allocated for it. */
+void freeOnlineDTW(struct onlineDTW *o);
+
+#endif
@@ -0,0 +1,161 @@
+/*
+    Implementation for module which collects output text in a large buffer.
+
+    A finite long double below 2^63 is M * 2^(e - 64) for a 64-bit integer
+        M, so value * 100 is (M * 100) / 2^(64 - e). M * 100 fits in 71
+        bits, so the whole number of hundredths and the remainder which
+        decides the rounding are found exactly with 128-bit integers.
+        Anything else is left to snprintf.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+#include "outputBuffer.h"
+
+/* Room kept free for one formatted value. */
+#define LONGEST_VALUE 64
+
+/* Values from 2^63 up are left to snprintf. */
+#define FAST_EXPONENT_LIMIT 64
+/* Bits of M * 100. Shifting further leaves less than half a hundredth. */
+#define SCALED_BITS 71
+
+struct outputBuffer {
+    FILE *outFile;
+    char *text;
+    size_t used;
+};
+
+/* Writes out the buffer if it might not have room for another value. */
+static inline void ensureRoom(struct outputBuffer *b, size_t length);
+
+struct outputBuffer *newOutputBuffer(FILE *outFile){
+    struct outputBuffer *b = (struct outputBuffer *)
+        malloc(sizeof(struct outputBuffer));
+    assert(b);
+    b->outFile = outFile;
+    b->text = (char *) malloc(OUTPUT_BUFFER_SIZE);
+    assert(b->text);
+    b->used = 0;
+    return b;
+}
+
+static inline void ensureRoom(struct outputBuffer *b, size_t length){
+    if(b->used + length > OUTPUT_BUFFER_SIZE){
+        flushOutputBuffer(b);
+    }
+}
+
+void bufferText(struct outputBuffer *b, const char *text, size_t length){
+    if(length > OUTPUT_BUFFER_SIZE){
+        flushOutputBuffer(b);
+        fwrite(text, 1, length, b->outFile);
+        return;
+    }
+    ensureRoom(b, length);
+    memcpy(b->text + b->used, text, length);
+    b->used += length;
+}
+
+void bufferChar(struct outputBuffer *b, char c){
+    ensureRoom(b, 1);
+    b->text[b->used++] = c;
+}
+
+void bufferInteger(struct outputBuffer *b, long long value){
+    ensureRoom(b, LONGEST_VALUE);
+    char *out = b->text + b->used;
+    unsigned long long magnitude = (unsigned long long) value;
+    if(value < 0){
+        *out++ = '-';
+        magnitude = -magnitude;
+    }
+    char digits[24];
+    int digitCount = 0;
+    do {
+        digits[digitCount++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while(magnitude > 0);
+    while(digitCount > 0){
+        *out++ = digits[--digitCount];
+    }
+    b->used = out - b->text;
+}
+
+void bufferFixed2(struct outputBuffer *b, long double value){
+    ensureRoom(b, LONGEST_VALUE);
+    char *out = b->text + b->used;
+
+#if LDBL_MANT_DIG == 64
+    int exponent;
+    long double fraction = frexpl(fabsl(value), &exponent);
+    if(isfinite(value) && exponent < FAST_EXPONENT_LIMIT){
+        unsigned long long mantissa = (unsigned long long)
+            ldexpl(fraction, 64);
+        unsigned __int128 scaled = (unsigned __int128) mantissa * 100;
+        int shift = 64 - exponent;
+        unsigned __int128 hundredths = 0;
+        if(value != 0 && shift < SCALED_BITS + 1){
+            unsigned __int128 whole = scaled >> shift;
+            unsigned __int128 remainder = scaled - (whole << shift);
+            unsigned __int128 half = (unsigned __int128) 1 << (shift - 1);
+            if(remainder > half || (remainder == half && (whole & 1))){
+                whole++;
+            }
+            hundredths = whole;
+        }
+
+        /* printf keeps the sign of values which round to zero. */
+        if(signbit(value)){
+            *out++ = '-';
+        }
+        unsigned long long units = (unsigned long long) (hundredths / 100);
+        int cents = hundredths % 100;
+        char digits[24];
+        int digitCount = 0;
+        do {
+            digits[digitCount++] = '0' + units % 10;
+            units /= 10;
+        } while(units > 0);
+        while(digitCount > 0){
+            *out++ = digits[--digitCount];
+        }
+        *out++ = '.';
+        *out++ = '0' + cents / 10;
+        *out++ = '0' + cents % 10;
+        b->used = out - b->text;
+        return;
+    }
+#endif
+
+    int length = snprintf(NULL, 0, "%.2Lf", value);
+    if(length < LONGEST_VALUE){
+        snprintf(out, LONGEST_VALUE, "%.2Lf", value);
+        b->used += length;
+    } else {
+        /* Huge values like LDINFINITY have thousands of digits. */
+        char *formatted = (char *) malloc(length + 1);
+        assert(formatted);
+        snprintf(formatted, length + 1, "%.2Lf", value);
+        bufferText(b, formatted, length);
+        free(formatted);
+    }
+}
+
+void flushOutputBuffer(struct outputBuffer *b){
+    if(b->used > 0){
+        fwrite(b->text, 1, b->used, b->outFile);
+        b->used = 0;
+    }
+}
+
+void freeOutputBuffer(struct outputBuffer *b){
+    if(b){
+        flushOutputBuffer(b);
+        free(b->text);
+        free(b);
+    }
+}
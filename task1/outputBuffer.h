@@ -0,0 +1,42 @@
+/*
+    Header for module which collects output text in a large buffer and
+        writes it out in a few big writes, with its own formatting of the
+        fixed two-decimal values DTW matrices are printed with.
+*/
+
+#ifndef OUTPUTBUFFER_H
+#define OUTPUTBUFFER_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+/* Bytes collected before they are written out. */
+#define OUTPUT_BUFFER_SIZE (1 << 20)
+
+struct outputBuffer;
+
+/* Creates a buffer which writes to the given file. */
+struct outputBuffer *newOutputBuffer(FILE *outFile);
+
+/* Adds the given number of characters of text to the buffer. */
+void bufferText(struct outputBuffer *b, const char *text, size_t length);
+
+/* Adds a single character to the buffer. */
+void bufferChar(struct outputBuffer *b, char c);
+
+/* Adds value to the buffer as printf's "%lld" would. */
+void bufferInteger(struct outputBuffer *b, long long value);
+
+/*
+    Adds value to the buffer exactly as printf's "%.2Lf" would, rounding
+    the exact value to the nearest hundredth, ties to even.
+*/
+void bufferFixed2(struct outputBuffer *b, long double value);
+
+/* Writes out everything in the buffer. */
+void flushOutputBuffer(struct outputBuffer *b);
+
+/* Writes out everything in the buffer, then frees it. */
+void freeOutputBuffer(struct outputBuffer *b);
+
+#endif
@@ -15,11 +15,22 @@
 #include <string.h>
 #include <ctype.h>
 #include <limits.h>
+#include <stdint.h>
 #include <float.h>
 #include <math.h>
+#include <unistd.h>
 #include "problem.h"
 #include "problemStruct.c"
 #include "solutionStruct.c"
+#include "wavefront.h"
+#include "simdKernel.h"
+#include "workspace.h"
+#include "sequenceFile.h"
+#include "warpingPath.h"
+#include "outputBuffer.h"
+#include "layerSweep.h"
+#include "dtwCore.h"
+#include "rowRanges.h"
 
 /* Number of words to allocate space for initially. */
 #define INITIALWORDSALLOCATION 64
@@ -27,76 +38,147 @@
 /* Denotes that the dimension has not yet been set. */
 #define DIMENSION_UNSET (-1)
 
-#define LDINFINITY (LDBL_MAX / 2.0L)
-
 struct problem;
 struct solution;
 
 /* Sets up a solution for the given problem. */
 struct solution *newSolution(struct problem *problem);
 
-void readSequence(FILE *seqFile, int *seqLen, long double **seq);
+/* Sets up a solution with no matrix or band allocated, from the problem's 
+    workspace if it has one. */
+static struct solution *newEmptySolution(struct problem *p);
 
-void readSequence(FILE *seqFile, int *seqLen, long double **seq){
-    char *seqText = NULL;
-    /* Read in text. */
-    size_t allocated = 0;
-    /* Exit if we read no characters or an error caught. */
-    int success = getdelim(&seqText, &allocated, '\0', seqFile);
-
-    if(success == -1){
-        /* Encountered an error. */
-        perror("Encountered error reading dictionary file");
-        exit(EXIT_FAILURE);
-    } else {
-        /* Assume file contains at least one character. */
-        assert(success > 0);
-    }
+/* Allocates memory for a solver, from the problem's workspace if it has one. */
+static void *solverAlloc(struct problem *p, enum workspaceBuffer buffer, 
+    size_t bytes);
 
-    /* Progress through string. */
-    int progress = 0;
-    /* Table string length. */
-    int seqTextLength = strlen(seqText);
+/* Frees memory from solverAlloc, unless it belongs to the workspace. */
+static void solverFree(struct problem *p, void *memory);
 
-    int commaCount = 0;
-    /* Count how many numbers are present. */
-    for(int i = 0; i < seqTextLength; i++){
-        if(seqText[i] == ','){
-            commaCount++;
-        }
-    }
-    long double *seqLocal = (long double *) malloc(sizeof(long double) * (commaCount + 1));
-    assert(seqLocal);
+/* If the problem asks for it, finds the warping path of a solved problem 
+    within the given window, or the solution's ranges if it has them. */
+static void findWarpingPath(struct problem *p, struct solution *s, 
+    int windowSize);
+
+/* Returns a pointer to cell (i, j) of a banded solution, which must lie
+    within the band or its guard cells. */
+static inline long double *bandCell(struct solution *s, int i, int j);
+
+/* Returns a pointer to cell (i, j) of a tiled solution. */
+static inline long double *tileCell(struct solution *s, int i, int j);
+
+/* Fills in a tiled Part A solution one tile at a time. */
+static void solveProblemATiled(struct problem *p, struct solution *s);
+
+/* Returns a Part D problem over copies of the problem's sequences in 
+    reverse, for the suffix costs of solveProblemDAdaptive. */
+static struct problem *newReversedProblem(struct problem *p);
+
+/* Sets the window of the reversed problem r to the cells of the problem's 
+    Sakoe-Chiba band of the given window size, |i - j| <= windowSize, 
+    which in r are those with |(j' - i') - (m - n)| <= windowSize. */
+static void setReversedBand(struct problem *p, struct problem *r, 
+    int windowSize);
+
+/* Returns the cost of cell (i, j) of the problem, using stepCost for 
+    multivariate problems as stepCosts does. */
+static long double cellCost(struct problem *p, int i, int j, 
+    long double *stepCost);
+
+/* Returns 1 if no path leaving the band of s can be cheaper than the best 
+    path inside it, given the same cells of the reversed problem in r (see 
+    setReversedBand). */
+static int bandIsExact(struct problem *p, struct solution *s, 
+    struct solution *r, long double *stepCost);
+
+/* Rough seconds per cell for each engine, measured on unoptimised builds. 
+    Only their ratios matter when choosing between strategies. */
+#define SCALAR_CELL_SECONDS 40e-9
+#define DOUBLE_CELL_SECONDS 4e-9
+#define FLOAT_CELL_SECONDS 2e-9
+#define INTEGER_CELL_SECONDS 2e-9
+/* Extra seconds to store a cell, row by row or in tiles. */
+#define STORED_CELL_SECONDS 20e-9
+#define TILED_CELL_SECONDS 14e-9
+
+/* Returns the rough seconds per cell of the engine solving the problem's 
+    Part A or D cells, or Part F's layers if layered. */
+static double engineCellSeconds(struct problem *p, int layered);
+
+/* Returns the number of cells of the Sakoe-Chiba band of the given window 
+    size, or of the window shape's ranges. */
+static double windowCells(struct problem *p, int windowSize);
+
+/* Returns the number of cells the Part F solvers visit, summed over the 
+    layers. */
+static double layerCells(int n, int m, int maxPathLength);
+
+/* Sets plan to the given strategy's costs, visiting the given number of 
+    cells with the given seconds each. */
+static void setPlan(struct solvePlan *plan, enum solveStrategy strategy, 
+    size_t bytes, double cells, double cellSeconds);
+
+/* Fills in a Part D solution stored as ranges of columns of each row. */
+static void solveProblemDRanges(struct problem *p, struct solution *s);
+
+/* Finds an optimal warping path through a solution stored as ranges of 
+    columns of each row, tracing back from (n, m) through its cells. */
+static void rangesWarpingPath(struct solution *s, int n, int m);
+
+/*
+    For a multivariate problem, sets cost[j] to the distance between step i 
+    of sequence A and step j of sequence B, for j from jFirst to jLast 
+    (indexed from 1, as in the matrix). If transposed, i is a step of 
+    sequence B and j of sequence A instead.
+*/
+static void stepCosts(struct problem *p, int transposed, int i, int jFirst, 
+    int jLast, long double *cost);
+
+/* The rowCosts of a multivariate problem's recurrence, where the context is 
+    the problem, for sequence A along the rows or down them if transposed. */
+static void problemRowCosts(void *context, int i, int jFirst, int jLast, 
+    long double *cost);
+static void transposedRowCosts(void *context, int i, int jFirst, int jLast, 
+    long double *cost);
+
+/* Returns 1 if the problem is univariate with the default cost and step 
+    pattern, the only recurrence the vectorised and parallel engines 
+    compute. */
+static int plainRecurrence(struct problem *p);
+
+/* Sets up the recurrence of the problem. A multivariate problem's step 
+    costs are computed into costRow, which must hold one cell more than the 
+    inner sequence. */
+static void setUpRecurrence(struct problem *p, int transposed, 
+    struct dtwRecurrence *r, long double *costRow);
+
+/* Returns the width of integers the problem can be solved in exactly by 
+    simdIntegerDTW, or 0 if it should not be (see simdIntegerWidth). Only 
+    single-threaded problems with the default recurrence are. */
+static int integerWidth(struct problem *p);
 
-    int seqAdded = 0;
-    while(progress < seqTextLength){
-        int nextProgress;
-        /* Read each value into the sequence. */
-        assert(sscanf(seqText + progress, "%Lf , %n", &seqLocal[seqAdded], &nextProgress) == 1);
-        assert(nextProgress > 0);
-        progress += nextProgress;
-        seqAdded++;
+void readSequence(FILE *seqFile, int *seqLen, long double **seq){
+    struct sequenceMapping *mapping = loadSequence(seqFile, seqLen, seq);
+    if(mapping){
+        /* The caller expects to own the values, so copy them out. */
+        long double *seqLocal = (long double *) malloc(sizeof(long double) * 
+            (*seqLen));
+        assert(seqLocal);
+        memcpy(seqLocal, *seq, sizeof(long double) * (*seqLen));
+        freeSequenceMapping(mapping);
+        *seq = seqLocal;
     }
-    assert(seqAdded == (commaCount + 1));
-    *seq = seqLocal;
-    *seqLen = seqAdded;
 }
 
-/* 
-    Reads the given dict file into a list of words 
-    and the given board file into a nxn board.
+/*
+    Creates a Part A problem over the given sequences, which are not copied
+    and are not freed by freeProblem.
 */
-struct problem *readProblemA(FILE *seqAFile, FILE *seqBFile){
+struct problem *newProblemA(long double *seqA, int seqALength, 
+    long double *seqB, int seqBLength){
     struct problem *p = (struct problem *) malloc(sizeof(struct problem));
     assert(p);
 
-    int seqALength = 0;
-    long double *seqA = NULL;
-    readSequence(seqAFile, &seqALength, &seqA);
-    int seqBLength = 0;
-    long double *seqB = NULL;
-    readSequence(seqBFile, &seqBLength, &seqB);
-
     /* The length of the first sequence. */
     p->seqALength = seqALength;
     /* The first sequence. */
@@ -107,15 +189,127 @@ struct problem *readProblemA(FILE *seqAFile, FILE *seqBFile){
     /* The second sequence. */
     p->sequenceB = seqB;
 
+    /* The caller keeps ownership of the sequences. */
+    p->ownsSequences = 0;
+    p->mappingA = NULL;
+    p->mappingB = NULL;
+
+    p->dimensions = 1;
+    p->metric = METRIC_L1;
+    p->stepsA = NULL;
+    p->stepsB = NULL;
+    p->cost = COST_ABSOLUTE;
+    p->step = STEP_SYMMETRIC1;
+    p->diagonalWeight = 1;
+
     /* For Part D & F only. */
     p->windowSize = -1;
+    p->windowShape = WINDOW_SAKOE_CHIBA;
+    p->itakuraSlope = 2;
+    p->rangeLo = NULL;
+    p->rangeHi = NULL;
     p->maximumPathLength = -1;
 
+    p->threadCount = 1;
+    p->precision = PRECISION_LONG_DOUBLE;
+    p->threshold = LDINFINITY;
+    p->workspace = NULL;
+    p->findPath = 0;
+    p->layout = MATRIX_ROWS;
+
     p->part = PART_A;
 
     return p;
 }
 
+struct problem *newProblemD(long double *seqA, int seqALength, 
+    long double *seqB, int seqBLength, int windowSize){
+    /* Fill in Part A sections. */
+    struct problem *p = newProblemA(seqA, seqALength, seqB, seqBLength);
+
+    p->part = PART_D;
+    p->windowSize = windowSize;
+
+    return p;
+}
+
+struct problem *newProblemF(long double *seqA, int seqALength, 
+    long double *seqB, int seqBLength, int maxPathLength){
+    struct problem *p = newProblemA(seqA, seqALength, seqB, seqBLength);
+
+    p->part = PART_F;
+    p->maximumPathLength = maxPathLength;
+
+    return p;
+}
+
+void setProblemSequences(struct problem *p, long double *seqA, 
+    int seqALength, long double *seqB, int seqBLength){
+    assert(p);
+    /* Let go of the old sequences and anything made from them. */
+    if(p->mappingA){
+        freeSequenceMapping(p->mappingA);
+    } else if(p->ownsSequences && p->sequenceA){
+        free(p->sequenceA);
+    }
+    if(p->mappingB){
+        freeSequenceMapping(p->mappingB);
+    } else if(p->ownsSequences && p->sequenceB){
+        free(p->sequenceB);
+    }
+    p->mappingA = NULL;
+    p->mappingB = NULL;
+    p->ownsSequences = 0;
+    free(p->stepsA);
+    free(p->stepsB);
+    p->stepsA = NULL;
+    p->stepsB = NULL;
+    if(p->windowShape == WINDOW_ROW_RANGES){
+        /* The ranges were for the old rows. */
+        free(p->rangeLo);
+        free(p->rangeHi);
+        p->rangeLo = NULL;
+        p->rangeHi = NULL;
+        p->windowShape = WINDOW_SAKOE_CHIBA;
+    }
+
+    p->sequenceA = seqA;
+    p->seqALength = seqALength;
+    p->sequenceB = seqB;
+    p->seqBLength = seqBLength;
+}
+
+/* 
+    Reads the given dict file into a list of words 
+    and the given board file into a nxn board.
+*/
+struct problem *readProblemA(FILE *seqAFile, FILE *seqBFile){
+    int seqALength = 0;
+    int dimensionsA = 1;
+    long double *seqA = NULL;
+    struct sequenceMapping *mappingA = loadMultivariateSequence(seqAFile, 
+        &seqALength, &dimensionsA, &seqA);
+    int seqBLength = 0;
+    int dimensionsB = 1;
+    long double *seqB = NULL;
+    struct sequenceMapping *mappingB = loadMultivariateSequence(seqBFile, 
+        &seqBLength, &dimensionsB, &seqB);
+    if(dimensionsA != dimensionsB){
+        fprintf(stderr, "Sequence A has %d values per step, but sequence B "
+            "has %d\n", dimensionsA, dimensionsB);
+        exit(EXIT_FAILURE);
+    }
+
+    struct problem *p = newProblemA(seqA, seqALength, seqB, seqBLength);
+    /* The sequences were read in here, so free them with the problem. */
+    p->ownsSequences = 1;
+    p->mappingA = mappingA;
+    p->mappingB = mappingB;
+    p->dimensions = dimensionsA;
+
+    return p;
+}
+
 struct problem *readProblemD(FILE *seqAFile, FILE *seqBFile, int windowSize){
     /* Fill in Part A sections. */
     struct problem *p = readProblemA(seqAFile, seqBFile);
@@ -137,36 +331,321 @@ struct problem *readProblemF(FILE *seqAFile, FILE *seqBFile,
     return p;
 }
 
+void setProblemThreadCount(struct problem *p, int threadCount){
+    assert(p);
+    p->threadCount = (threadCount > 1) ? threadCount : 1;
+}
+
+void setProblemPrecision(struct problem *p, enum dtwPrecision precision){
+    assert(p);
+    p->precision = precision;
+}
+
+void setProblemThreshold(struct problem *p, long double threshold){
+    assert(p);
+    p->threshold = threshold;
+}
+
+void setProblemWorkspace(struct problem *p, struct workspace *workspace){
+    assert(p);
+    p->workspace = workspace;
+}
+
+void setProblemWarpingPath(struct problem *p, int findPath){
+    assert(p);
+    p->findPath = findPath;
+}
+
+void setProblemDimensions(struct problem *p, int dimensions){
+    assert(p && dimensions > 0);
+    p->dimensions = dimensions;
+}
+
+void setProblemMetric(struct problem *p, enum stepMetric metric){
+    assert(p);
+    p->metric = metric;
+}
+
+void setProblemCost(struct problem *p, enum dtwCost cost){
+    assert(p);
+    p->cost = cost;
+}
+
+void setProblemStepPattern(struct problem *p, enum stepPattern step, 
+    long double diagonalWeight){
+    assert(p);
+    p->step = step;
+    p->diagonalWeight = diagonalWeight;
+}
+
+void setProblemWindowShape(struct problem *p, enum windowShape shape, 
+    long double slope){
+    assert(p);
+    assert(shape != WINDOW_ITAKURA || slope >= 1);
+    assert(shape != WINDOW_ROW_RANGES || p->rangeLo);
+    p->windowShape = shape;
+    p->itakuraSlope = slope;
+}
+
+void setProblemRowRanges(struct problem *p, int *lo, int *hi, int rowCount){
+    assert(p);
+    int n = p->seqALength;
+    free(p->rangeLo);
+    free(p->rangeHi);
+    p->rangeLo = (int *) malloc(sizeof(int) * n);
+    assert(p->rangeLo);
+    p->rangeHi = (int *) malloc(sizeof(int) * n);
+    assert(p->rangeHi);
+    for(int i = 0; i < n; i++){
+        /* Rows without a range admit nothing. */
+        p->rangeLo[i] = (i < rowCount) ? lo[i] : 1;
+        p->rangeHi[i] = (i < rowCount) ? hi[i] : 0;
+    }
+    p->windowShape = WINDOW_ROW_RANGES;
+}
+
+static void stepCosts(struct problem *p, int transposed, int i, int jFirst, 
+    int jLast, long double *cost){
+    if(! p->stepsA){
+        /* The kernels work in double, so convert the sequences once. */
+        size_t valuesA = (size_t) p->dimensions * p->seqALength;
+        size_t valuesB = (size_t) p->dimensions * p->seqBLength;
+        p->stepsA = (double *) malloc(sizeof(double) * valuesA);
+        assert(p->stepsA);
+        p->stepsB = (double *) malloc(sizeof(double) * valuesB);
+        assert(p->stepsB);
+        for(size_t v = 0; v < valuesA; v++){
+            p->stepsA[v] = (double) p->sequenceA[v];
+        }
+        for(size_t v = 0; v < valuesB; v++){
+            p->stepsB[v] = (double) p->sequenceB[v];
+        }
+    }
+    if(jLast < jFirst){
+        return;
+    }
+    if(transposed){
+        simdStepDistances(p->stepsB, p->seqBLength, i - 1, p->stepsA, 
+            p->seqALength, jFirst - 1, jLast - jFirst + 1, p->dimensions, 
+            p->metric, cost + jFirst);
+    } else {
+        simdStepDistances(p->stepsA, p->seqALength, i - 1, p->stepsB, 
+            p->seqBLength, jFirst - 1, jLast - jFirst + 1, p->dimensions, 
+            p->metric, cost + jFirst);
+    }
+}
+
+static void problemRowCosts(void *context, int i, int jFirst, int jLast, 
+    long double *cost){
+    struct problem *p = (struct problem *) context;
+    stepCosts(p, 0, i, jFirst, jLast, cost);
+    if(p->cost == COST_SQUARED){
+        for(int j = jFirst; j <= jLast; j++){
+            cost[j] *= cost[j];
+        }
+    }
+}
+
+static void transposedRowCosts(void *context, int i, int jFirst, int jLast, 
+    long double *cost){
+    struct problem *p = (struct problem *) context;
+    stepCosts(p, 1, i, jFirst, jLast, cost);
+    if(p->cost == COST_SQUARED){
+        for(int j = jFirst; j <= jLast; j++){
+            cost[j] *= cost[j];
+        }
+    }
+}
+
+static int plainRecurrence(struct problem *p){
+    return p->dimensions == 1 && p->cost == COST_ABSOLUTE && 
+        p->step == STEP_SYMMETRIC1;
+}
+
+static int integerWidth(struct problem *p){
+    if(! plainRecurrence(p) || p->threadCount > 1){
+        return 0;
+    }
+    return simdIntegerWidth(p->sequenceA, p->seqALength, p->sequenceB, 
+        p->seqBLength);
+}
+
+static void setUpRecurrence(struct problem *p, int transposed, 
+    struct dtwRecurrence *r, long double *costRow){
+    r->cost = p->cost;
+    r->step = p->step;
+    r->diagonalWeight = p->diagonalWeight;
+    r->rowCosts = NULL;
+    r->context = p;
+    r->costRow = costRow;
+    if(p->dimensions > 1){
+        r->rowCosts = transposed ? transposedRowCosts : problemRowCosts;
+    }
+}
+
+void setProblemMatrixLayout(struct problem *p, enum matrixLayout layout){
+    assert(p);
+    p->layout = layout;
+}
+
+static void *solverAlloc(struct problem *p, enum workspaceBuffer buffer, 
+    size_t bytes){
+    if(p->workspace){
+        return workspaceBuffer(p->workspace, buffer, bytes);
+    }
+    void *memory = malloc(bytes);
+    assert(memory);
+    return memory;
+}
+
+static void solverFree(struct problem *p, void *memory){
+    if(! p->workspace){
+        free(memory);
+    }
+}
+
 /*
-    Outputs the given solution to the given file. If colourMode is 1, the
-    sentence in the problem is coloured with the given solution colours.
+    Outputs the given solution to the given file. The matrix is formatted 
+    into a large buffer and written out in a few big writes.
 */
 void outputProblem(struct problem *problem, struct solution *solution, 
     FILE *outfileName){
     assert(solution);
-    fprintf(outfileName, "%.2Lf\n", solution->optimalValue);
+    if(solution->exceedsThreshold){
+        /* The matrix was abandoned part way through. */
+        fprintf(outfileName, "exceeds threshold\n");
+        return;
+    }
+    struct outputBuffer *out = newOutputBuffer(outfileName);
+    bufferFixed2(out, solution->optimalValue);
+    bufferChar(out, '\n');
     switch(problem->part){
         case PART_A:
-            assert(solution->matrix);
+            if(! solution->matrix && ! solution->tiles){
+                /* Distance-only solution, no matrix to print. */
+                break;
+            }
             for(int i = 1; i <= problem->seqALength; i++){
                 for(int j = 1; j <= problem->seqBLength; j++){
-                    if(solution->matrix[i][j] == LDINFINITY){
-                        fprintf(outfileName, "    ");
+                    long double cell = getSolutionCell(solution, i, j);
+                    if(cell == LDINFINITY){
+                        bufferText(out, "    ", 4);
                     } else {
-                        fprintf(outfileName, "%.2Lf", solution->matrix[i][j]);
+                        bufferFixed2(out, cell);
                     }
                     if(j < (problem->seqBLength)){
                         /* Intercalate with spaces. */
-                        fprintf(outfileName, " ");
+                        bufferChar(out, ' ');
                     }
                 }
-                fprintf(outfileName, "\n");
+                bufferChar(out, '\n');
             }
             break;
         case PART_D:
         case PART_F:
             break;
     }
+    /* The path, one cell per line, from (1,1) to (n,m). */
+    for(int k = 0; k < solution->pathLength; k++){
+        bufferChar(out, '(');
+        bufferInteger(out, solution->pathI[k]);
+        bufferChar(out, ',');
+        bufferInteger(out, solution->pathJ[k]);
+        bufferText(out, ")\n", 2);
+    }
+    freeOutputBuffer(out);
+}
+
+int outputProblemMatrix(struct problem *problem, struct solution *solution, 
+    FILE *outfileName){
+    assert(solution);
+    if(! solution->matrix && ! solution->tiles && ! solution->band && 
+        ! solution->rangeCells){
+        return 0;
+    }
+    struct matrixFileHeader header;
+    memset(&header, 0, sizeof(struct matrixFileHeader));
+    memcpy(header.magic, MATRIX_FILE_MAGIC, SEQUENCE_FILE_MAGIC_SIZE);
+    header.elementType = SEQUENCE_LONG_DOUBLE;
+    header.elementSize = sizeof(long double);
+    header.rows = problem->seqALength;
+    header.columns = problem->seqBLength;
+    fwrite(&header, sizeof(struct matrixFileHeader), 1, outfileName);
+
+    /* Write a row at a time, with unused bytes of each value zeroed. */
+    long double *row = (long double *) calloc(problem->seqBLength, 
+        sizeof(long double));
+    assert(row);
+    for(int i = 1; i <= problem->seqALength; i++){
+        for(int j = 1; j <= problem->seqBLength; j++){
+            row[j - 1] = getSolutionCell(solution, i, j);
+        }
+        fwrite(row, sizeof(long double), problem->seqBLength, outfileName);
+    }
+    free(row);
+
+    return 1;
+}
+
+static inline long double *bandCell(struct solution *s, int i, int j){
+    return &(s->band[(size_t) i * s->bandStride + (j - i + s->bandRadius + 1)]);
+}
+
+/* Tiles are stored a row of tiles at a time, each tile's cells row-major. */
+static inline long double *tileCell(struct solution *s, int i, int j){
+    size_t tile = (size_t) (i / MATRIX_TILE_SIZE) * s->tileColumns + 
+        j / MATRIX_TILE_SIZE;
+    return &(s->tiles[tile * MATRIX_TILE_SIZE * MATRIX_TILE_SIZE + 
+        (i % MATRIX_TILE_SIZE) * MATRIX_TILE_SIZE + (j % MATRIX_TILE_SIZE)]);
+}
+
+/*
+    Returns cell (i, j) of the solution's matrix, whether stored in full, in
+    tiles, as a band or as per-row ranges of columns. Cells outside the
+    stored band or ranges are infinite.
+*/
+long double getSolutionCell(struct solution *solution, int i, int j){
+    assert(solution);
+    if(solution->matrix){
+        return solution->matrix[i][j];
+    }
+    if(solution->tiles){
+        return *tileCell(solution, i, j);
+    }
+    if(solution->rangeCells){
+        if(j < solution->rangeLo[i] || j > solution->rangeHi[i]){
+            return LDINFINITY;
+        }
+        return solution->rangeCells[solution->rangeOffset[i] + 
+            (j - solution->rangeLo[i])];
+    }
+    assert(solution->band);
+    if(abs(j - i) > solution->bandRadius){
+        return LDINFINITY;
+    }
+    return *bandCell(solution, i, j);
+}
+
+long double getOptimalValue(struct solution *solution){
+    assert(solution);
+    return solution->optimalValue;
+}
+
+int solutionExceedsThreshold(struct solution *solution){
+    assert(solution);
+    return solution->exceedsThreshold;
+}
+
+int getSolutionPath(struct solution *solution, int **pathI, int **pathJ){
+    assert(solution);
+    *pathI = solution->pathI;
+    *pathJ = solution->pathJ;
+    return solution->pathLength;
+}
+
+int getSolutionWindowSize(struct solution *solution){
+    assert(solution);
+    return solution->band ? solution->bandRadius : 0;
 }
 
 /*
@@ -174,13 +653,25 @@ void outputProblem(struct problem *problem, struct solution *solution,
 */
 void freeSolution(struct solution *solution, struct problem *problem){
     if(solution){
-        if(solution->matrix){
-            for(int i = 0; i < problem->seqALength; i++){
-                free(solution->matrix[i]);
-            }
+        /* Storage from a workspace is kept for the next solve. */
+        if(solution->ownsStorage && solution->matrix){
+            free(solution->matrix[0]);
             free(solution->matrix);
         }
-        free(solution);
+        if(solution->ownsStorage && solution->band){
+            free(solution->band);
+        }
+        if(solution->ownsStorage && solution->tiles){
+            free(solution->tiles);
+        }
+        if(solution->ownsStorage && solution->rangeCells){
+            free(solution->rangeCells);
+            free(solution->rangeLo);
+            free(solution->rangeOffset);
+        }
+        workspaceFree(solution->workspace, solution->pathI);
+        workspaceFree(solution->workspace, solution->pathJ);
+        workspaceFree(solution->workspace, solution);
     }
 }
 
@@ -189,37 +680,122 @@ void freeSolution(struct solution *solution, struct problem *problem){
 */
 void freeProblem(struct problem *problem){
     if(problem){
-        if(problem->sequenceA){
+        /* Mapped sequences are unmapped rather than freed. */
+        if(problem->mappingA){
+            freeSequenceMapping(problem->mappingA);
+        } else if(problem->ownsSequences && problem->sequenceA){
             free(problem->sequenceA);
         }
-        if(problem->sequenceB){
+        if(problem->mappingB){
+            freeSequenceMapping(problem->mappingB);
+        } else if(problem->ownsSequences && problem->sequenceB){
             free(problem->sequenceB);
         }
+        free(problem->stepsA);
+        free(problem->stepsB);
+        free(problem->rangeLo);
+        free(problem->rangeHi);
         free(problem);
     }
 }
 
+/* Sets up a solution with no matrix or band allocated. */
+static struct solution *newEmptySolution(struct problem *p){
+    struct solution *s = (struct solution *) workspaceAlloc(p->workspace, 
+        sizeof(struct solution));
+    s->workspace = p->workspace;
+    s->matrix = NULL;
+    s->band = NULL;
+    s->tiles = NULL;
+    s->rangeCells = NULL;
+    s->rangeLo = NULL;
+    s->rangeHi = NULL;
+    s->rangeOffset = NULL;
+    s->tileColumns = 0;
+    s->bandRadius = 0;
+    s->bandStride = 0;
+    s->ownsStorage = 1;
+    s->pathI = NULL;
+    s->pathJ = NULL;
+    s->pathLength = 0;
+    s->optimalValue = -1;
+    s->exceedsThreshold = 0;
+
+    return s;
+}
+
 /* Sets up a solution for the given problem */
 struct solution *newSolution(struct problem *problem){
-    struct solution *s = (struct solution *) malloc(sizeof(struct solution));
-    assert(s);
+    struct solution *s = newEmptySolution(problem);
+    s->ownsStorage = (problem->workspace == NULL);
     if(problem->part == PART_F){
-        s->matrix = NULL;
+        /* Part F only needs the optimal value. */
+    } else if(problem->part == PART_D && 
+        problem->windowShape != WINDOW_SAKOE_CHIBA){
+        /* Only the admissible cells of each row are stored. */
+        int n = problem->seqALength;
+        int m = problem->seqBLength;
+        s->rangeLo = (int *) solverAlloc(problem, WORKSPACE_RANGE_BOUNDS, 
+            sizeof(int) * 2 * (n + 1));
+        s->rangeHi = s->rangeLo + (n + 1);
+        switch(problem->windowShape){
+            case WINDOW_SLANTED_BAND:
+                slantedBandRanges(n, m, problem->windowSize, s->rangeLo, 
+                    s->rangeHi);
+                break;
+            case WINDOW_ITAKURA:
+                itakuraRanges(n, m, problem->itakuraSlope, s->rangeLo, 
+                    s->rangeHi);
+                break;
+            case WINDOW_ROW_RANGES:
+                givenRanges(n, m, problem->rangeLo, problem->rangeHi, 
+                    s->rangeLo, s->rangeHi);
+                break;
+            case WINDOW_SAKOE_CHIBA:
+                break;
+        }
+        s->rangeOffset = (size_t *) solverAlloc(problem, 
+            WORKSPACE_RANGE_OFFSETS, sizeof(size_t) * (n + 2));
+        size_t cells = rowRangeOffsets(n, s->rangeLo, s->rangeHi, 
+            s->rangeOffset);
+        s->rangeCells = (long double *) solverAlloc(problem, 
+            WORKSPACE_RANGE_CELLS, sizeof(long double) * cells);
+    } else if(problem->part == PART_D){
+        /* A window wider than the longer sequence covers every cell anyway. */
+        int longest = problem->seqALength > problem->seqBLength ? 
+            problem->seqALength : problem->seqBLength;
+        s->bandRadius = problem->windowSize < longest ? 
+            problem->windowSize : longest;
+        if(s->bandRadius < -1){
+            /* Negative windows admit no cells. */
+            s->bandRadius = -1;
+        }
+        s->bandStride = 2 * s->bandRadius + 3;
+        size_t cells = (size_t) (problem->seqALength + 1) * s->bandStride;
+        s->band = (long double *) solverAlloc(problem, WORKSPACE_BAND, 
+            sizeof(long double) * cells);
+    } else if(problem->layout == MATRIX_TILES && plainRecurrence(problem)){
+        /* One block of square tiles, each stored row by row. The solver 
+            initialises every cell itself. */
+        size_t tileRows = problem->seqALength / MATRIX_TILE_SIZE + 1;
+        s->tileColumns = problem->seqBLength / MATRIX_TILE_SIZE + 1;
+        s->tiles = (long double *) solverAlloc(problem, 
+            WORKSPACE_MATRIX_CELLS, sizeof(long double) * tileRows * 
+            s->tileColumns * MATRIX_TILE_SIZE * MATRIX_TILE_SIZE);
     } else {
-        s->matrix = (long double **) malloc(sizeof(long double *) * 
+        /* One block of cells, with a pointer to the start of each row. The 
+            solver initialises every cell itself. */
+        s->matrix = (long double **) solverAlloc(problem, 
+            WORKSPACE_MATRIX_ROWS, sizeof(long double *) * 
             (problem->seqALength + 1));
-        assert(s->matrix);
+        size_t columns = (size_t) problem->seqBLength + 1;
+        long double *cells = (long double *) solverAlloc(problem, 
+            WORKSPACE_MATRIX_CELLS, sizeof(long double) * 
+            (problem->seqALength + 1) * columns);
         for(int i = 0; i < (problem->seqALength + 1); i++){
-            s->matrix[i] = (long double *) malloc(sizeof(long double) * 
-                (problem->seqBLength + 1));
-            assert(s->matrix[i]);
-            for(int j = 0; j < (problem->seqBLength + 1); j++){
-                s->matrix[i][j] = 0;
-            }
+            s->matrix[i] = cells + i * columns;
         }
     }
-
-    s->optimalValue = -1;
     
     return s;
 }
@@ -237,71 +813,648 @@ struct solution *solveProblemA(struct problem *p){
     int n = p->seqALength;       // number of rows in the matrix                  
     int m = p->seqBLength;       // number of columns in the matrix
     
-    /* Initialise the DTW matrix */
-    for (i = 0; i <= n; i++) {
-        for (j = 0; j <= m; j++) {
-            s->matrix[i][j] = LDINFINITY;
+    /* Part A is unconstrained, so use a window as wide as the matrix */
+    int longest = (n > m) ? n : m;
+    /* Multivariate costs are only computed by the scalar solver */
+    int plain = plainRecurrence(p);
+
+    if (s->tiles) {
+        solveProblemATiled(p, s);
+        s->optimalValue = *tileCell(s, n, m);
+        s->exceedsThreshold = (s->optimalValue > p->threshold);
+        findWarpingPath(p, s, longest);
+        return s;
+    }
+
+    /* Whole numbers are summed exactly in integers, if they fit */
+    int width = integerWidth(p);
+
+    /* Initialise the boundary of the DTW matrix. Every other cell is 
+        computed, unless the vectorised sweep is abandoned part way */
+    if ((width || (p->precision != PRECISION_LONG_DOUBLE && plain)) && 
+        p->threshold < LDINFINITY) {
+        for (i = 1; i <= n; i++) {
+            for (j = 1; j <= m; j++) {
+                s->matrix[i][j] = LDINFINITY;
+            }
         }
     }
+    for (j = 0; j <= m; j++) {
+        s->matrix[0][j] = LDINFINITY;
+    }
+    for (i = 1; i <= n; i++) {
+        s->matrix[i][0] = LDINFINITY;
+    }
     s->matrix[0][0] = 0;
 
-    /* Populate the DTW matrix */
-    long double cost;
-    for (i = 1; i <= n; i++) {
-        for (j = 1; j <= m; j++) {
-            cost = fabsl(p->sequenceA[i-1] - p->sequenceB[j-1]);
-            s->matrix[i][j] = cost + fminl(s->matrix[i-1][j], fminl(s->matrix[i][j-1], s->matrix[i-1][j-1]));
+    if (width) {
+        /* Populate the DTW matrix by vectorised integer anti-diagonals */
+        simdIntegerDTW(p->sequenceA, n, p->sequenceB, m, longest, width, 
+            p->threshold, s->matrix, NULL, p->workspace);
+    } else if (p->precision != PRECISION_LONG_DOUBLE && plain) {
+        /* Populate the DTW matrix by vectorised anti-diagonals */
+        simdDTW(p->sequenceA, n, p->sequenceB, m, longest, p->precision, 
+            p->threshold, s->matrix, NULL, p->workspace);
+    } else if (p->threadCount > 1 && plain) {
+        /* Populate the DTW matrix in parallel tiles */
+        wavefrontDTW(p->sequenceA, n, p->sequenceB, m, longest, 
+            p->threadCount, s->matrix, NULL, p->workspace);
+    } else {
+        /* Populate the DTW matrix, stopping early if a whole row exceeds 
+            the threshold, leaving the rest of the matrix infinite */
+        struct dtwRecurrence r;
+        long double *stepCost = NULL;
+        if (p->dimensions > 1) {
+            stepCost = (long double *) solverAlloc(p, WORKSPACE_STEP_COSTS, 
+                sizeof(long double) * (m + 1));
+        }
+        setUpRecurrence(p, 0, &r, stepCost);
+        int stopped = dtwCoreFill(&r, p->sequenceA, n, p->sequenceB, m, 
+            longest, p->threshold, s->matrix, n + 1, NULL);
+        /* Leave the rest of an abandoned matrix infinite */
+        for (i = (stopped ? stopped + 1 : n + 1); i <= n; i++) {
+            for (j = 1; j <= m; j++) {
+                s->matrix[i][j] = LDINFINITY;
+            }
+        }
+        if (stepCost) {
+            solverFree(p, stepCost);
         }
     }
 
     /* The DTW distance is in the bottom-right corner of the matrix */
     s->optimalValue = s->matrix[n][m];
+    s->exceedsThreshold = (s->optimalValue > p->threshold);
+    findWarpingPath(p, s, longest);
+
+    return s;
+}
+
+/*
+    Fills in a tiled Part A solution tile by tile, each tile row by row, so 
+    the cells written and the row above them read are contiguous within a 
+    tile. Stops early if the whole of a row of tiles' last row exceeds the 
+    threshold, leaving the rest of the matrix infinite.
+*/
+static void solveProblemATiled(struct problem *p, struct solution *s){
+    int i, j, c;
+    int n = p->seqALength;
+    int m = p->seqBLength;
+    int tileRows = n / MATRIX_TILE_SIZE + 1;
+
+    /* Initialise the boundary of the DTW matrix */
+    for (j = 0; j <= m; j++) {
+        *tileCell(s, 0, j) = LDINFINITY;
+    }
+    for (i = 1; i <= n; i++) {
+        *tileCell(s, i, 0) = LDINFINITY;
+    }
+    *tileCell(s, 0, 0) = 0;
+
+    for (int tileRow = 0; tileRow < tileRows; tileRow++) {
+        int iFirst = (tileRow == 0) ? 1 : tileRow * MATRIX_TILE_SIZE;
+        int iLast = tileRow * MATRIX_TILE_SIZE + MATRIX_TILE_SIZE - 1;
+        if (iLast > n) {
+            iLast = n;
+        }
+        long double lastRowMin = LDINFINITY;
+        for (int tileColumn = 0; tileColumn < s->tileColumns; tileColumn++) {
+            int jFirst = (tileColumn == 0) ? 1 : tileColumn * MATRIX_TILE_SIZE;
+            int jLast = tileColumn * MATRIX_TILE_SIZE + MATRIX_TILE_SIZE - 1;
+            if (jLast > m) {
+                jLast = m;
+            }
+            for (i = iFirst; i <= iLast; i++) {
+                /* Row i and row i - 1 of the tile's columns are contiguous, 
+                    the cells to their left are in the tile to the left */
+                long double *row = tileCell(s, i, jFirst);
+                long double *above = tileCell(s, i - 1, jFirst);
+                long double left = *tileCell(s, i, jFirst - 1);
+                long double diagonal = *tileCell(s, i - 1, jFirst - 1);
+                long double a = p->sequenceA[i-1];
+                for (c = 0; c <= jLast - jFirst; c++) {
+                    long double up = above[c];
+                    long double cost = fabsl(a - p->sequenceB[jFirst + c - 1]);
+                    row[c] = cost + fminl(up, fminl(left, diagonal));
+                    left = row[c];
+                    diagonal = up;
+                    if (i == iLast && row[c] < lastRowMin) {
+                        lastRowMin = row[c];
+                    }
+                }
+            }
+        }
+        if (lastRowMin > p->threshold) {
+            /* Leave the rest of an abandoned matrix infinite */
+            for (i = iLast + 1; i <= n; i++) {
+                for (j = 1; j <= m; j++) {
+                    *tileCell(s, i, j) = LDINFINITY;
+                }
+            }
+            break;
+        }
+    }
+}
+
+/*
+    Computes the DTW cost of the problem over cells where 
+    |i - j| <= windowSize using only two rolling rows of length 
+    (innerLength + 1), so memory is linear in the inner sequence, 
+    which is sequence B, or sequence A if transposed. Both rows are taken 
+    from rows, which must hold 2 * (innerLength + 1) cells, or 3 * 
+    (innerLength + 1) for a multivariate problem, the third holding the 
+    step costs of the current row. Returns infinity as soon as a whole row 
+    exceeds the threshold.
+*/
+static long double rollingRowDistance(struct problem *p, int transposed, 
+    int windowSize, long double *rows){
+    int j;
+    long double *outer = transposed ? p->sequenceB : p->sequenceA;
+    int outerLength = transposed ? p->seqBLength : p->seqALength;
+    long double *inner = transposed ? p->sequenceA : p->sequenceB;
+    int innerLength = transposed ? p->seqALength : p->seqBLength;
+    /* Row i of the DTW matrix is rollingRows[i % 2] */
+    long double *rollingRows[2] = {rows, rows + (innerLength + 1)};
+    struct dtwRecurrence r;
+    setUpRecurrence(p, transposed, &r, rows + 2 * (innerLength + 1));
+
+    /* Row 0 of the DTW matrix, and infinity past the end of each row's 
+        window, which is never written */
+    for (j = 0; j <= innerLength; j++) {
+        rollingRows[0][j] = LDINFINITY;
+        rollingRows[1][j] = LDINFINITY;
+    }
+    rollingRows[0][0] = 0;
+
+    /* Each row only needs the row above it */
+    if (dtwCoreFill(&r, outer, outerLength, inner, innerLength, windowSize, 
+        p->threshold, rollingRows, 2, NULL)) {
+        return LDINFINITY;
+    }
+
+    return rollingRows[outerLength % 2][innerLength];
+}
+
+struct solution *solveProblemADistance(struct problem *p){
+    /* No matrix is kept, outputProblem only prints the optimal value. */
+    struct solution *s = newEmptySolution(p);
+
+    int longest = (p->seqALength > p->seqBLength) ? 
+        p->seqALength : p->seqBLength;
+    int plain = plainRecurrence(p);
+    int width = integerWidth(p);
+    if (width) {
+        /* Whole numbers are summed exactly in integers */
+        s->optimalValue = simdIntegerDTW(p->sequenceA, p->seqALength, 
+            p->sequenceB, p->seqBLength, longest, width, p->threshold, 
+            NULL, NULL, p->workspace);
+    } else if (p->precision != PRECISION_LONG_DOUBLE && plain) {
+        /* Only three anti-diagonals are kept without an output */
+        s->optimalValue = simdDTW(p->sequenceA, p->seqALength, 
+            p->sequenceB, p->seqBLength, longest, p->precision, p->threshold, 
+            NULL, NULL, p->workspace);
+    } else if (p->threadCount > 1 && plain) {
+        /* The wavefront engine only keeps tile edges without an output */
+        s->optimalValue = wavefrontDTW(p->sequenceA, p->seqALength, 
+            p->sequenceB, p->seqBLength, longest, p->threadCount, NULL, NULL, 
+            p->workspace);
+    } else {
+        /* DTW is symmetric, so roll along whichever sequence is shorter */
+        int shortest = (p->seqBLength <= p->seqALength) ? 
+            p->seqBLength : p->seqALength;
+        long double *rows = (long double *) solverAlloc(p, 
+            WORKSPACE_ROLLING_ROWS, sizeof(long double) * 
+            (p->dimensions > 1 ? 3 : 2) * (shortest + 1));
+        s->optimalValue = rollingRowDistance(p, 
+            (p->seqBLength > p->seqALength), longest, rows);
+        solverFree(p, rows);
+    }
+    s->exceedsThreshold = (s->optimalValue > p->threshold);
+    findWarpingPath(p, s, longest);
+
+    return s;
+}
+
+struct solution *solveProblemDDistance(struct problem *p){
+    if (p->windowShape != WINDOW_SAKOE_CHIBA) {
+        /* Only the Sakoe-Chiba band is rolled */
+        return solveProblemD(p);
+    }
+    struct solution *s = newEmptySolution(p);
+
+    int longest = (p->seqALength > p->seqBLength) ? 
+        p->seqALength : p->seqBLength;
+    int windowSize = (p->windowSize < longest) ? p->windowSize : longest;
+    int plain = plainRecurrence(p);
+    int width = integerWidth(p);
+    if (windowSize < abs(p->seqALength - p->seqBLength)) {
+        /* Cell (n, m) is outside the window */
+        s->optimalValue = LDINFINITY;
+    } else if (width) {
+        s->optimalValue = simdIntegerDTW(p->sequenceA, p->seqALength, 
+            p->sequenceB, p->seqBLength, windowSize, width, p->threshold, 
+            NULL, NULL, p->workspace);
+    } else if (p->precision != PRECISION_LONG_DOUBLE && plain) {
+        s->optimalValue = simdDTW(p->sequenceA, p->seqALength, 
+            p->sequenceB, p->seqBLength, windowSize, p->precision, 
+            p->threshold, NULL, NULL, p->workspace);
+    } else if (p->threadCount > 1 && plain) {
+        s->optimalValue = wavefrontDTW(p->sequenceA, p->seqALength, 
+            p->sequenceB, p->seqBLength, windowSize, p->threadCount, NULL, 
+            NULL, p->workspace);
+    } else {
+        /* The window is symmetric, so roll along the shorter sequence */
+        int shortest = (p->seqBLength <= p->seqALength) ? 
+            p->seqBLength : p->seqALength;
+        long double *rows = (long double *) solverAlloc(p, 
+            WORKSPACE_ROLLING_ROWS, sizeof(long double) * 
+            (p->dimensions > 1 ? 3 : 2) * (shortest + 1));
+        s->optimalValue = rollingRowDistance(p, 
+            (p->seqBLength > p->seqALength), windowSize, rows);
+        solverFree(p, rows);
+    }
+    s->exceedsThreshold = (s->optimalValue > p->threshold);
+    findWarpingPath(p, s, windowSize);
 
     return s;
 }
 
 struct solution *solveProblemD(struct problem *p){
     struct solution *s = newSolution(p);
+    if (s->rangeCells) {
+        solveProblemDRanges(p, s);
+        return s;
+    }
     /* Fill in: Part D */
-    int i, j;
+    int i;
 
-    /* Get window size */
-    int windowSize = p->windowSize;
+    /* Get window size, clamped to the stored band */
+    int windowSize = s->bandRadius;
 
     /* Initialise the lengths of sequences */
     int n = p->seqALength;       // number of rows in the matrix                  
     int m = p->seqBLength;       // number of columns in the matrix
 
-    /* Initialise the DTW matrix */
-    for (i = 0; i <= n; i++) {
-        for (int j = 0; j <= m; j++) {
-            s->matrix[i][j] = LDINFINITY;
-        }
+    /* Initialise the band, including its guard cells */
+    size_t cells = (size_t) (n + 1) * s->bandStride;
+    for (size_t c = 0; c < cells; c++) {
+        s->band[c] = LDINFINITY;
+    }
+    if (s->bandRadius >= 0) {
+        *bandCell(s, 0, 0) = 0;
     }
-    s->matrix[0][0] = 0;
 
-    /* Populate the DTW matrix, but skip calculations outside the window */
-    long double cost;
-    for (i = 1; i <= n; i++) {
-        for (j = 1; j <= m; j++) {
-            /* Check if cell is inside the window */
-            if (abs(j - i) <= windowSize) {
-                cost = fabsl(p->sequenceA[i-1] - p->sequenceB[j-1]);
-                s->matrix[i][j] = cost + fminl(s->matrix[i-1][j], fminl(s->matrix[i][j-1], s->matrix[i-1][j-1]));
+    if (windowSize >= 0) {
+        /* Populate the band, only visiting cells inside the window, 
+            pointing the solver at the start of each row of the band. The 
+            guard cells stand in for neighbours just outside the window. */
+        long double **rows = (long double **) solverAlloc(p, 
+            WORKSPACE_BAND_ROWS, sizeof(long double *) * (n + 1));
+        int *rowStart = (int *) solverAlloc(p, WORKSPACE_BAND_ROW_STARTS, 
+            sizeof(int) * (n + 1));
+        for (i = 0; i <= n; i++) {
+            rowStart[i] = i - windowSize - 1;
+            rows[i] = bandCell(s, i, rowStart[i]);
+        }
+        int width = integerWidth(p);
+        if (width) {
+            simdIntegerDTW(p->sequenceA, n, p->sequenceB, m, windowSize, 
+                width, p->threshold, rows, rowStart, p->workspace);
+        } else if (p->precision != PRECISION_LONG_DOUBLE && 
+            plainRecurrence(p)) {
+            simdDTW(p->sequenceA, n, p->sequenceB, m, windowSize, 
+                p->precision, p->threshold, rows, rowStart, p->workspace);
+        } else if (p->threadCount > 1 && plainRecurrence(p)) {
+            wavefrontDTW(p->sequenceA, n, p->sequenceB, m, windowSize, 
+                p->threadCount, rows, rowStart, p->workspace);
+        } else {
+            /* Stop early if the whole of a row's band exceeds the 
+                threshold */
+            struct dtwRecurrence r;
+            long double *stepCost = NULL;
+            if (p->dimensions > 1) {
+                stepCost = (long double *) solverAlloc(p, 
+                    WORKSPACE_STEP_COSTS, sizeof(long double) * (m + 1));
+            }
+            setUpRecurrence(p, 0, &r, stepCost);
+            dtwCoreFill(&r, p->sequenceA, n, p->sequenceB, m, windowSize, 
+                p->threshold, rows, n + 1, rowStart);
+            if (stepCost) {
+                solverFree(p, stepCost);
             }
         }
+        solverFree(p, rows);
+        solverFree(p, rowStart);
     }
 
     /* The DTW distance is in the bottom-right corner of the matrix */
-    s->optimalValue = s->matrix[n][m];
+    s->optimalValue = getSolutionCell(s, n, m);
+    s->exceedsThreshold = (s->optimalValue > p->threshold);
+    findWarpingPath(p, s, windowSize);
+
+    return s;
+}
+
+static void solveProblemDRanges(struct problem *p, struct solution *s){
+    int n = p->seqALength;
+    int m = p->seqBLength;
+    s->rangeCells[0] = 0;
+
+    struct dtwRecurrence r;
+    long double *stepCost = NULL;
+    if (p->dimensions > 1) {
+        stepCost = (long double *) solverAlloc(p, WORKSPACE_STEP_COSTS, 
+            sizeof(long double) * (m + 1));
+    }
+    setUpRecurrence(p, 0, &r, stepCost);
+    long double *above = (long double *) solverAlloc(p, 
+        WORKSPACE_RANGE_ABOVE, sizeof(long double) * (m + 1));
+    int abandonedRow = dtwCoreFillRanges(&r, p->sequenceA, n, p->sequenceB, 
+        m, s->rangeLo, s->rangeHi, s->rangeOffset, s->rangeCells, above, 
+        p->threshold);
+    if (abandonedRow) {
+        /* The rows never reached can only be worse */
+        for (size_t c = s->rangeOffset[abandonedRow + 1]; 
+            c < s->rangeOffset[n + 1]; c++) {
+            s->rangeCells[c] = LDINFINITY;
+        }
+    }
+    solverFree(p, above);
+    if (stepCost) {
+        solverFree(p, stepCost);
+    }
+
+    s->optimalValue = getSolutionCell(s, n, m);
+    s->exceedsThreshold = (s->optimalValue > p->threshold);
+    findWarpingPath(p, s, 0);
+}
+
+static void rangesWarpingPath(struct solution *s, int n, int m){
+    int maxLength = n + m - 1;
+    s->pathI = (int *) workspaceAlloc(s->workspace, sizeof(int) * maxLength);
+    s->pathJ = (int *) workspaceAlloc(s->workspace, sizeof(int) * maxLength);
+    /* Each cell came from its cheapest neighbour, the diagonal if tied. 
+        Cells outside the ranges are infinite, so never chosen. */
+    int i = n;
+    int j = m;
+    int length = 0;
+    while (1) {
+        s->pathI[length] = i;
+        s->pathJ[length] = j;
+        length++;
+        if (i == 1 && j == 1) {
+            break;
+        }
+        long double diagonal = getSolutionCell(s, i - 1, j - 1);
+        long double up = getSolutionCell(s, i - 1, j);
+        long double left = getSolutionCell(s, i, j - 1);
+        if (diagonal <= up && diagonal <= left) {
+            i--;
+            j--;
+        } else if (up <= left) {
+            i--;
+        } else {
+            j--;
+        }
+    }
+    /* Put the path in order from (1, 1) */
+    for (int k = 0; k < length / 2; k++) {
+        int swap = s->pathI[k];
+        s->pathI[k] = s->pathI[length - 1 - k];
+        s->pathI[length - 1 - k] = swap;
+        swap = s->pathJ[k];
+        s->pathJ[k] = s->pathJ[length - 1 - k];
+        s->pathJ[length - 1 - k] = swap;
+    }
+    s->pathLength = length;
+}
+
+static void findWarpingPath(struct problem *p, struct solution *s, 
+    int windowSize){
+    if(! p->findPath || s->exceedsThreshold || s->optimalValue >= LDINFINITY || 
+        ! plainRecurrence(p)){
+        return;
+    }
+    if(s->rangeCells){
+        /* The whole window is stored, so it is traced back directly */
+        rangesWarpingPath(s, p->seqALength, p->seqBLength);
+        return;
+    }
+    /* Recovered in linear space, so it doesn't need the matrix */
+    int maxLength = p->seqALength + p->seqBLength - 1;
+    s->pathI = (int *) workspaceAlloc(s->workspace, sizeof(int) * maxLength);
+    s->pathJ = (int *) workspaceAlloc(s->workspace, sizeof(int) * maxLength);
+    s->pathLength = warpingPath(p->sequenceA, p->seqALength, p->sequenceB, 
+        p->seqBLength, windowSize, s->pathI, s->pathJ, p->workspace);
+}
+
+/*
+    A path leaving the band first steps out from an edge cell e to a cell c 
+    just outside it, and last steps back in at an edge cell q on the same 
+    side, after c, staying in the band before p and after q. Its cost is 
+    then at least the band's cost of reaching e, plus the cost of c, plus 
+    the cheapest path from q to (n, m) in the band, which is a cell of the 
+    reversed problem's band. If that bound is no less than the band's 
+    distance for every c, the band's distance is exact.
+*/
+struct solution *solveProblemDAdaptive(struct problem *p){
+    int n = p->seqALength;
+    int m = p->seqBLength;
+    int longest = (n > m) ? n : m;
+    int lengthDifference = (n > m) ? (n - m) : (m - n);
+
+    /* Narrower bands than the length difference admit no paths. */
+    int windowSize = p->windowSize;
+    if (windowSize < lengthDifference) {
+        windowSize = lengthDifference;
+    }
+    if (windowSize < 1) {
+        windowSize = 1;
+    }
+
+    /* Only the final band is compared against the threshold, and only its 
+        path is found */
+    long double threshold = p->threshold;
+    int findPath = p->findPath;
+    enum windowShape windowShape = p->windowShape;
+    p->threshold = LDINFINITY;
+    p->findPath = 0;
+    p->windowShape = WINDOW_SAKOE_CHIBA;
+
+    struct problem *reversed = NULL;
+    long double *stepCost = NULL;
+    if (p->dimensions > 1) {
+        stepCost = (long double *) workspaceAlloc(p->workspace, 
+            sizeof(long double) * (m + 1));
+    }
+    struct solution *s;
+    while (1) {
+        p->windowSize = windowSize;
+        s = solveProblemD(p);
+        if (windowSize >= longest) {
+            /* The band covers the whole matrix */
+            break;
+        }
+        if (! reversed) {
+            reversed = newReversedProblem(p);
+        }
+        setReversedBand(p, reversed, windowSize);
+        struct solution *r = solveProblemD(reversed);
+        int exact = bandIsExact(p, s, r, stepCost);
+        freeSolution(r, reversed);
+        if (exact) {
+            break;
+        }
+        freeSolution(s, p);
+        windowSize = (windowSize > longest / 2) ? longest : 2 * windowSize;
+    }
+
+    p->threshold = threshold;
+    p->findPath = findPath;
+    p->windowShape = windowShape;
+    s->exceedsThreshold = (s->optimalValue > p->threshold);
+    findWarpingPath(p, s, windowSize);
+
+    if (reversed) {
+        freeProblem(reversed);
+    }
+    if (stepCost) {
+        workspaceFree(p->workspace, stepCost);
+    }
 
     return s;
 }
 
+static struct problem *newReversedProblem(struct problem *p){
+    int n = p->seqALength;
+    int m = p->seqBLength;
+    int dimensions = p->dimensions;
+    long double *seqA = (long double *) malloc(sizeof(long double) * 
+        dimensions * n);
+    assert(seqA);
+    long double *seqB = (long double *) malloc(sizeof(long double) * 
+        dimensions * m);
+    assert(seqB);
+    /* Each dimension's run is reversed in place */
+    for (int d = 0; d < dimensions; d++) {
+        for (int i = 0; i < n; i++) {
+            seqA[(size_t) d * n + i] = p->sequenceA[(size_t) d * n + n - 1 - i];
+        }
+        for (int j = 0; j < m; j++) {
+            seqB[(size_t) d * m + j] = p->sequenceB[(size_t) d * m + m - 1 - j];
+        }
+    }
+
+    struct problem *r = newProblemD(seqA, n, seqB, m, p->windowSize);
+    r->ownsSequences = 1;
+    r->dimensions = dimensions;
+    r->metric = p->metric;
+    r->cost = p->cost;
+    r->threadCount = p->threadCount;
+    r->precision = p->precision;
+    /* Every cell of a path counts once, reversed or not, so symmetric1 
+        gives suffix costs, which bandIsExact scales down to a bound for 
+        other step patterns. The problem's workspace still holds its own 
+        band. */
+    r->step = STEP_SYMMETRIC1;
+
+    return r;
+}
+
+static void setReversedBand(struct problem *p, struct problem *r, 
+    int windowSize){
+    int n = p->seqALength;
+    int m = p->seqBLength;
+    int *lo = (int *) malloc(sizeof(int) * n);
+    assert(lo);
+    int *hi = (int *) malloc(sizeof(int) * n);
+    assert(hi);
+    /* Row i' of r is row n + 1 - i', and column j' column m + 1 - j', so 
+        the band follows the diagonal j' = i' + m - n */
+    for (int i = 1; i <= n; i++) {
+        int first = i + (m - n) - windowSize;
+        int last = i + (m - n) + windowSize;
+        lo[i - 1] = (first > 1) ? first : 1;
+        hi[i - 1] = (last < m) ? last : m;
+    }
+    r->windowSize = windowSize;
+    setProblemRowRanges(r, lo, hi, n);
+    free(lo);
+    free(hi);
+}
+
+static long double cellCost(struct problem *p, int i, int j, 
+    long double *stepCost){
+    long double cost;
+    if (p->dimensions > 1) {
+        stepCosts(p, 0, i, j, j, stepCost);
+        cost = stepCost[j];
+    } else {
+        cost = fabsl(p->sequenceA[i-1] - p->sequenceB[j-1]);
+    }
+    if (p->cost == COST_SQUARED) {
+        cost *= cost;
+    }
+    return cost;
+}
+
+static int bandIsExact(struct problem *p, struct solution *s, 
+    struct solution *r, long double *stepCost){
+    int i, j;
+    int n = p->seqALength;
+    int m = p->seqBLength;
+    int w = s->bandRadius;
+    long double distance = s->optimalValue;
+    /* Steps after q may cost less than symmetric1's once per cell, by at 
+        most the diagonal weight */
+    long double scale = 1;
+    if (p->step == STEP_WEIGHTED_DIAGONAL && p->diagonalWeight < 1) {
+        scale = (p->diagonalWeight > 0) ? p->diagonalWeight : 0;
+    }
+
+    /* Leaving above the band, from e = (i, i + w) to c = (i, i + w + 1), 
+        and coming back in at some q = (i', i' + w) with i' > i */
+    long double suffixMin = LDINFINITY;
+    int iLast = (m - w < n) ? (m - w) : n;
+    for (i = iLast; i >= 1; i--) {
+        if (i + w + 1 <= m) {
+            long double bound = getSolutionCell(s, i, i + w) + 
+                cellCost(p, i, i + w + 1, stepCost) + scale * suffixMin;
+            if (bound < distance) {
+                return 0;
+            }
+        }
+        long double suffix = getSolutionCell(r, n + 1 - i, m + 1 - (i + w));
+        if (suffix < suffixMin) {
+            suffixMin = suffix;
+        }
+    }
+
+    /* Leaving below the band, from e = (j + w, j) to c = (j + w + 1, j), 
+        and coming back in at some q = (j' + w, j') with j' > j */
+    suffixMin = LDINFINITY;
+    int jLast = (n - w < m) ? (n - w) : m;
+    for (j = jLast; j >= 1; j--) {
+        if (j + w + 1 <= n) {
+            long double bound = getSolutionCell(s, j + w, j) + 
+                cellCost(p, j + w + 1, j, stepCost) + scale * suffixMin;
+            if (bound < distance) {
+                return 0;
+            }
+        }
+        long double suffix = getSolutionCell(r, n + 1 - (j + w), m + 1 - j);
+        if (suffix < suffixMin) {
+            suffixMin = suffix;
+        }
+    }
+
+    return 1;
+}
+
 struct solution *solveProblemF(struct problem *p){
     struct solution *s = newSolution(p);
     /* Fill in: Part F */
-    int i, j, k;
+    int i, j, k, layer;
 
     /* Get the maximum path length */
     int maxPathLength = p->maximumPathLength;
@@ -310,75 +1463,458 @@ struct solution *solveProblemF(struct problem *p){
     int n = p->seqALength;       // number of rows in the matrix                  
     int m = p->seqBLength;       // number of columns in the matrix
 
-    /* Create a 3D matrix where there is an extra 'depth' dimension. Each
-        'layer' of this new 'depth' dimension stores a 2D DTW matrix with a
-        specific maximum-path-length the DTW algorithm can take. Values of
-        these path lengths range from 1 up to maxPathLength. Therefore, there
-        will be maxPathLength number of 'layers' in the 3D matrix. */
-
-    /* Create the matrix layers */
-    long double ***matrix = (long double ***) malloc(sizeof(long double **) * (maxPathLength + 1));
-    assert(matrix);
-
-    /* For each layer, create a 2D DTW matrix */
-    /* Create rows */
-    for (k = 0; k <= maxPathLength; k++) {
-        matrix[k] = (long double **) malloc(sizeof(long double *) * (n + 1));
-        assert(matrix[k]);
-        /* Create columns */
-        for (i = 0; i <= n; i++) {
-            matrix[k][i] = (long double *) malloc(sizeof(long double) * (m + 1));
-            assert(matrix[k][i]);
-        }
+    /* Conceptually there is a 3D matrix where each 'layer' k is a 2D DTW 
+        matrix restricted to paths of exactly k cells. Layer k only reads 
+        layer k - 1, so only two layers are kept and they are reused 
+        alternately, keeping the running minimum of cell (n, m). */
+
+    /* Threads or reduced precision use the layer engine, which computes 
+        each layer's rows with vector kernels shared out among threads */
+    if ((p->threadCount > 1 || p->precision != PRECISION_LONG_DOUBLE) && 
+        plainRecurrence(p)) {
+        s->optimalValue = layerDTW(p->sequenceA, n, p->sequenceB, m, 
+            maxPathLength, p->threadCount, p->precision, p->workspace);
+        return s;
     }
-    
-    /* Initialise all the DTW matrices */
-    for (k = 0; k <= maxPathLength; k++) {
+
+    /* Create the two matrix layers, as one block of cells */
+    long double **layerRows = (long double **) solverAlloc(p, 
+        WORKSPACE_LAYER_ROWS, sizeof(long double *) * 2 * (n + 1));
+    long double *layerCells = (long double *) solverAlloc(p, 
+        WORKSPACE_LAYER_CELLS, sizeof(long double) * 2 * (n + 1) * (m + 1));
+    long double **matrix[2];
+    for (layer = 0; layer < 2; layer++) {
+        matrix[layer] = layerRows + layer * (n + 1);
         for (i = 0; i <= n; i++) {
+            matrix[layer][i] = layerCells + ((size_t) layer * (n + 1) + i) * (m + 1);
             for (j = 0; j <= m; j++) {
-                matrix[k][i][j] = LDINFINITY;
+                matrix[layer][i][j] = LDINFINITY;
             }
         }
-        matrix[k][0][0] = 0;
+        matrix[layer][0][0] = 0;
     }
 
-    /* Populate the DTW matrices, but skip invalid cells, i.e. cells that are
-        not reachable within a given number of steps. */
-    long double cost;
-    for (k = 1; k <= maxPathLength; k++) {
-        for (i = 1; i <= n; i++) {
-            for (j = 1; j <= m; j++) {
-                /* Only compute matrix cell that are valid */
-                if (((i <= k) && (j <= k)) && (i + j > k)) {
-                    cost = fabsl(p->sequenceA[i-1] - p->sequenceB[j-1]); 
-                    matrix[k][i][j] = cost + fminl(matrix[k-1][i-1][j], fminl(matrix[k-1][i][j-1], matrix[k-1][i-1][j-1]));
-                }
+    /* No cell is reachable in n + m or more steps, so stop before then. */
+    int lastLayer = (maxPathLength < n + m - 1) ? maxPathLength : (n + m - 1);
+    /* Cell (n, m) is only reachable once k is at least max(n, m). */
+    int firstEndLayer = (n > m) ? n : m;
+
+    /* Populate the layers, only visiting cells reachable in exactly k 
+        steps, i.e. max(i, j) <= k < i + j. */
+    struct dtwRecurrence r;
+    long double minCost = LDINFINITY;
+    long double *stepCost = NULL;
+    if (p->dimensions > 1) {
+        stepCost = (long double *) solverAlloc(p, WORKSPACE_STEP_COSTS, 
+            sizeof(long double) * (m + 1));
+    }
+    setUpRecurrence(p, 0, &r, stepCost);
+    for (k = 1; k <= lastLayer; k++) {
+        long double **current = matrix[k % 2];
+        long double **previous = matrix[(k - 1) % 2];
+        int iEnd = (k < n) ? k : n;
+        int jEnd = (k < m) ? k : m;
+        for (i = 1; i <= iEnd; i++) {
+            int jStart = (k - i + 1 > 1) ? (k - i + 1) : 1;
+            /* Layer k - 2 also reached the two cells before jStart in this
+                row, which are not reachable in exactly k steps. */
+            int staleStart = (jStart - 2 > 1) ? (jStart - 2) : 1;
+            for (j = staleStart; j < jStart && j <= m; j++) {
+                current[i][j] = LDINFINITY;
+            }
+            if (jStart <= jEnd) {
+                dtwCoreLayerRow(&r, p->sequenceA, p->sequenceB, i, jStart, 
+                    jEnd, current[i], previous[i-1], previous[i]);
             }
         }
-    }
 
-    /* The DTW distance is the minimum cost across the third dimension at the
-        last indices of the two sequences i.e., (n, m) */
-    long double minCost = LDINFINITY;
-    for (k = 1; k <= maxPathLength; k++) {
-        if (matrix[k][n][m] < minCost) {
-            minCost = matrix[k][n][m];
+        /* The DTW distance is the minimum cost across the layers at the
+            last indices of the two sequences i.e., (n, m) */
+        if (k >= firstEndLayer && current[n][m] < minCost) {
+            minCost = current[n][m];
         }
     }
     s->optimalValue = minCost;
 
     /* Free memory allocated to matrix */
-    for (k = 0; k <= maxPathLength; k++) {
-        for (i = 0; i <= n; i++) {
-            free(matrix[k][i]);
-            matrix[k][i] = NULL;
-        }
-        free(matrix[k]);
-        matrix[k] = NULL;
+    if (stepCost) {
+        solverFree(p, stepCost);
     }
-    free(matrix);
-    matrix = NULL;
+    solverFree(p, layerCells);
+    solverFree(p, layerRows);
 
     return s;
 }
 
+static double engineCellSeconds(struct problem *p, int layered){
+    int plain = plainRecurrence(p);
+    int threads = (p->threadCount > 1) ? p->threadCount : 1;
+    if (! layered && integerWidth(p)) {
+        return INTEGER_CELL_SECONDS;
+    }
+    if (plain && p->precision == PRECISION_DOUBLE) {
+        return DOUBLE_CELL_SECONDS / (layered ? threads : 1);
+    }
+    if (plain && p->precision == PRECISION_FLOAT) {
+        return FLOAT_CELL_SECONDS / (layered ? threads : 1);
+    }
+    if (plain) {
+        return SCALAR_CELL_SECONDS / threads;
+    }
+    /* Multivariate step distances cost about a vector cell per dimension */
+    return SCALAR_CELL_SECONDS + p->dimensions * DOUBLE_CELL_SECONDS;
+}
+
+static double windowCells(struct problem *p, int windowSize){
+    int n = p->seqALength;
+    int m = p->seqBLength;
+    double cells = 0;
+    if (p->windowShape != WINDOW_SAKOE_CHIBA) {
+        /* Work the ranges out, as newSolution will */
+        int *lo = (int *) malloc(sizeof(int) * 2 * (n + 1));
+        assert(lo);
+        int *hi = lo + (n + 1);
+        switch (p->windowShape) {
+            case WINDOW_SLANTED_BAND:
+                slantedBandRanges(n, m, p->windowSize, lo, hi);
+                break;
+            case WINDOW_ITAKURA:
+                itakuraRanges(n, m, p->itakuraSlope, lo, hi);
+                break;
+            case WINDOW_ROW_RANGES:
+                givenRanges(n, m, p->rangeLo, p->rangeHi, lo, hi);
+                break;
+            case WINDOW_SAKOE_CHIBA:
+                break;
+        }
+        for (int i = 0; i <= n; i++) {
+            cells += hi[i] - lo[i] + 1;
+        }
+        free(lo);
+        return cells;
+    }
+    for (int i = 1; i <= n; i++) {
+        int jStart = (i - windowSize > 1) ? (i - windowSize) : 1;
+        int jEnd = (i + windowSize < m) ? (i + windowSize) : m;
+        if (jStart <= jEnd) {
+            cells += jEnd - jStart + 1;
+        }
+    }
+    return cells;
+}
+
+static double layerCells(int n, int m, int maxPathLength){
+    int lastLayer = (maxPathLength < n + m - 1) ? maxPathLength : (n + m - 1);
+    double cells = 0;
+    for (int k = 1; k <= lastLayer; k++) {
+        /* Row i < k of layer k runs from column k - i + 1 to min(k, m), 
+            i - max(k - m, 0) cells, and row k (if any) has min(k, m). */
+        double skipped = (k > m) ? (k - m) : 0;
+        double first = (k - m + 1 > 1) ? (k - m + 1) : 1;
+        double last = (k - 1 < n) ? (k - 1) : n;
+        if (first <= last) {
+            cells += (first + last) * (last - first + 1) / 2 - 
+                skipped * (last - first + 1);
+        }
+        if (k <= n) {
+            cells += (k < m) ? k : m;
+        }
+    }
+    return cells;
+}
+
+static void setPlan(struct solvePlan *plan, enum solveStrategy strategy, 
+    size_t bytes, double cells, double cellSeconds){
+    plan->strategy = strategy;
+    plan->bytes = bytes;
+    plan->seconds = cells * cellSeconds;
+}
+
+int planProblem(struct problem *p, int distanceOnly, struct solvePlan *plans){
+    size_t n = p->seqALength;
+    size_t m = p->seqBLength;
+    size_t shortest = (n < m) ? n : m;
+    size_t longest = (n > m) ? n : m;
+    size_t cell = sizeof(long double);
+    /* Every engine keeps a few vectors as long as the sequences, and 
+        multivariate problems a double precision copy of each */
+    size_t linearBytes = 4 * (n + m + 2) * cell;
+    if (p->dimensions > 1) {
+        linearBytes += (n + m) * p->dimensions * sizeof(double);
+    }
+    int count = 0;
+
+    if (p->part == PART_A) {
+        double cells = (double) n * m;
+        if (p->layout == MATRIX_TILES && plainRecurrence(p)) {
+            size_t tiles = (n / MATRIX_TILE_SIZE + 1) * 
+                (m / MATRIX_TILE_SIZE + 1);
+            setPlan(&plans[count++], STRATEGY_TILED_MATRIX, linearBytes + 
+                tiles * MATRIX_TILE_SIZE * MATRIX_TILE_SIZE * cell, cells, 
+                SCALAR_CELL_SECONDS + TILED_CELL_SECONDS);
+        } else {
+            setPlan(&plans[count++], STRATEGY_FULL_MATRIX, linearBytes + 
+                (n + 1) * sizeof(long double *) + (n + 1) * (m + 1) * cell, 
+                cells, engineCellSeconds(p, 0) + STORED_CELL_SECONDS);
+        }
+        if (distanceOnly) {
+            setPlan(&plans[count++], STRATEGY_ROLLING_ROWS, linearBytes + 
+                3 * (shortest + 1) * cell, cells, engineCellSeconds(p, 0));
+        }
+    } else if (p->part == PART_D) {
+        int windowSize = (p->windowSize < (int) longest) ? 
+            p->windowSize : (int) longest;
+        double cells = windowCells(p, windowSize);
+        if (p->windowShape != WINDOW_SAKOE_CHIBA) {
+            /* The admitted cells, with each row's bounds and offset */
+            setPlan(&plans[count++], STRATEGY_BAND, linearBytes + 
+                (size_t) cells * cell + (n + 2) * (2 * sizeof(int) + 
+                sizeof(size_t)), cells, 
+                SCALAR_CELL_SECONDS + STORED_CELL_SECONDS);
+        } else {
+            size_t stride = 2 * (windowSize >= -1 ? windowSize : -1) + 3;
+            setPlan(&plans[count++], STRATEGY_BAND, linearBytes + 
+                (n + 1) * (stride * cell + sizeof(long double *) + 
+                sizeof(int)), cells, 
+                engineCellSeconds(p, 0) + STORED_CELL_SECONDS);
+            if (distanceOnly) {
+                setPlan(&plans[count++], STRATEGY_ROLLING_ROWS, linearBytes + 
+                    3 * (shortest + 1) * cell, cells, 
+                    engineCellSeconds(p, 0));
+            }
+        }
+    } else {
+        /* Only two rolling layers of (n + 1) x (m + 1) cells are kept. The 
+            layer engine keeps them in its own precision, with the sequences 
+            converted to it, and the long double loop indexes them by row */
+        int layerEngine = (p->threadCount > 1 || 
+            p->precision != PRECISION_LONG_DOUBLE) && plainRecurrence(p);
+        size_t layerCell = cell;
+        if (layerEngine && p->precision == PRECISION_DOUBLE) {
+            layerCell = sizeof(double);
+        } else if (layerEngine && p->precision == PRECISION_FLOAT) {
+            layerCell = sizeof(float);
+        }
+        size_t layerBytes = 2 * (n + 1) * (m + 1) * layerCell;
+        if (layerEngine) {
+            layerBytes += (n + m) * layerCell;
+        } else {
+            layerBytes += 2 * (n + 1) * sizeof(long double *);
+        }
+        setPlan(&plans[count++], STRATEGY_ROLLING_LAYERS, 
+            linearBytes + layerBytes, layerCells(n, m, p->maximumPathLength), 
+            engineCellSeconds(p, 1) + STORED_CELL_SECONDS);
+    }
+
+    return count;
+}
+
+int chooseProblemPlan(struct problem *p, int distanceOnly, 
+    size_t memoryBudget, struct solvePlan *plan){
+    if (memoryBudget == 0) {
+        memoryBudget = (size_t) sysconf(_SC_PHYS_PAGES) * 
+            (size_t) sysconf(_SC_PAGESIZE);
+    }
+    struct solvePlan plans[STRATEGY_COUNT];
+    int count = planProblem(p, distanceOnly, plans);
+    assert(count > 0);
+    int fastest = -1;
+    int smallest = 0;
+    for (int k = 0; k < count; k++) {
+        if (plans[k].bytes <= memoryBudget && 
+            (fastest < 0 || plans[k].seconds < plans[fastest].seconds)) {
+            fastest = k;
+        }
+        if (plans[k].bytes < plans[smallest].bytes) {
+            smallest = k;
+        }
+    }
+    *plan = plans[(fastest >= 0) ? fastest : smallest];
+    return (fastest >= 0);
+}
+
+struct solution *solveProblemPlan(struct problem *p, struct solvePlan *plan){
+    switch (plan->strategy) {
+        case STRATEGY_FULL_MATRIX:
+        case STRATEGY_TILED_MATRIX:
+            return solveProblemA(p);
+        case STRATEGY_ROLLING_ROWS:
+            if (p->part == PART_D) {
+                return solveProblemDDistance(p);
+            }
+            return solveProblemADistance(p);
+        case STRATEGY_BAND:
+            return solveProblemD(p);
+        case STRATEGY_ROLLING_LAYERS:
+            return solveProblemF(p);
+    }
+    assert(0 && "unknown strategy");
+    return NULL;
+}
+
+const char *getStrategyName(enum solveStrategy strategy){
+    switch (strategy) {
+        case STRATEGY_FULL_MATRIX:
+            return "full matrix";
+        case STRATEGY_TILED_MATRIX:
+            return "tiled matrix";
+        case STRATEGY_ROLLING_ROWS:
+            return "rolling rows";
+        case STRATEGY_BAND:
+            return "band";
+        case STRATEGY_ROLLING_LAYERS:
+            return "rolling layers";
+    }
+    return "unknown";
+}
+
+size_t parseMemorySize(const char *text){
+    char *end;
+    double bytes = strtod(text, &end);
+    if (end == text) {
+        return 0;
+    }
+    switch (*end) {
+        case 'G':
+        case 'g':
+            bytes *= 1024;
+            /* Fall through */
+        case 'M':
+        case 'm':
+            bytes *= 1024;
+            /* Fall through */
+        case 'K':
+        case 'k':
+            bytes *= 1024;
+            end++;
+            break;
+        default:
+            break;
+    }
+    if (*end != '\0' || ! (bytes >= 1) || bytes > (double) SIZE_MAX) {
+        return 0;
+    }
+    return (size_t) bytes;
+}
+
+void initSolveOptions(struct solveOptions *options){
+    options->distanceOnly = 0;
+    options->threadCount = 1;
+    options->precision = PRECISION_LONG_DOUBLE;
+    options->threshold = LDINFINITY;
+    options->findPath = 0;
+    options->metric = METRIC_L1;
+    options->cost = COST_ABSOLUTE;
+    options->step = STEP_SYMMETRIC1;
+    options->diagonalWeight = 1;
+    options->memoryBudget = 0;
+}
+
+int parseSolveOption(int argc, char **argv, int *arg, const char *accepted, 
+    struct solveOptions *options){
+    char *flag = argv[*arg];
+    if (flag[0] != '-' || flag[1] == '\0' || flag[2] != '\0' || 
+        ! strchr(accepted, flag[1])) {
+        return 0;
+    }
+    /* Flags without a value */
+    switch (flag[1]) {
+        case 'd':
+            options->distanceOnly = 1;
+            return 1;
+        case 'a':
+            options->findPath = 1;
+            return 1;
+        case 't':
+        case 'p':
+        case 'e':
+        case 'm':
+        case 'c':
+        case 's':
+        case 'w':
+        case 'M':
+            break;
+        default:
+            return 0;
+    }
+    if (*arg + 1 >= argc) {
+        fprintf(stderr, "Option \"%s\" needs a value\n", flag);
+        return -1;
+    }
+    (*arg)++;
+    char *value = argv[*arg];
+    switch (flag[1]) {
+        case 't':
+            options->threadCount = strtol(value, NULL, 10);
+            break;
+        case 'p':
+            if (strcmp(value, "long") == 0) {
+                options->precision = PRECISION_LONG_DOUBLE;
+            } else if (strcmp(value, "double") == 0) {
+                options->precision = PRECISION_DOUBLE;
+            } else if (strcmp(value, "float") == 0) {
+                options->precision = PRECISION_FLOAT;
+            } else {
+                fprintf(stderr, "Unrecognised precision \"%s\"\n", value);
+                return -1;
+            }
+            break;
+        case 'e':
+            options->threshold = strtold(value, NULL);
+            break;
+        case 'm':
+            if (strcmp(value, "l1") == 0) {
+                options->metric = METRIC_L1;
+            } else if (strcmp(value, "l2") == 0) {
+                options->metric = METRIC_L2;
+            } else {
+                fprintf(stderr, "Unrecognised metric \"%s\"\n", value);
+                return -1;
+            }
+            break;
+        case 'c':
+            if (strcmp(value, "abs") == 0) {
+                options->cost = COST_ABSOLUTE;
+            } else if (strcmp(value, "squared") == 0) {
+                options->cost = COST_SQUARED;
+            } else {
+                fprintf(stderr, "Unrecognised cost \"%s\"\n", value);
+                return -1;
+            }
+            break;
+        case 's':
+            if (strcmp(value, "symmetric1") == 0) {
+                options->step = STEP_SYMMETRIC1;
+            } else if (strcmp(value, "symmetric2") == 0) {
+                options->step = STEP_SYMMETRIC2;
+            } else if (strcmp(value, "weighted") == 0) {
+                options->step = STEP_WEIGHTED_DIAGONAL;
+            } else {
+                fprintf(stderr, "Unrecognised step pattern \"%s\"\n", 
+                    value);
+                return -1;
+            }
+            break;
+        case 'w':
+            options->diagonalWeight = strtold(value, NULL);
+            break;
+        case 'M':
+            options->memoryBudget = parseMemorySize(value);
+            if (options->memoryBudget == 0) {
+                fprintf(stderr, "Unrecognised memory size \"%s\"\n", value);
+                return -1;
+            }
+            break;
+    }
+    return 1;
+}
+
+void setProblemSolveOptions(struct problem *p, struct solveOptions *options){
+    setProblemThreadCount(p, options->threadCount);
+    setProblemPrecision(p, options->precision);
+    setProblemThreshold(p, options->threshold);
+    setProblemWarpingPath(p, options->findPath);
+    setProblemMetric(p, options->metric);
+    setProblemCost(p, options->cost);
+    setProblemStepPattern(p, options->step, options->diagonalWeight);
+}
@@ -6,12 +6,190 @@
         data structures and functions.
 */
 #include <stdio.h>
+#include <float.h>
+
+/* Value of matrix cells which cannot be reached. */
+#define LDINFINITY (LDBL_MAX / 2.0L)
 
 struct problem;
 struct solution;
+struct workspace;
+
+#ifndef DTWPRECISIONENUM_DEF
+#define DTWPRECISIONENUM_DEF 1
+/* Floating point type the DTW recurrence is computed in. */
+enum dtwPrecision {
+    PRECISION_LONG_DOUBLE = 0,
+    PRECISION_DOUBLE = 1,
+    PRECISION_FLOAT = 2
+};
+#endif
+
+#ifndef MATRIXLAYOUTENUM_DEF
+#define MATRIXLAYOUTENUM_DEF 1
+/* How a Part A matrix is laid out in memory. */
+enum matrixLayout {
+    /* One block of rows, each row contiguous. */
+    MATRIX_ROWS = 0,
+    /* One block of square tiles of MATRIX_TILE_SIZE cells a side, each 
+        tile contiguous and stored row by row. */
+    MATRIX_TILES = 1
+};
+#endif
+
+#ifndef STEPMETRICENUM_DEF
+#define STEPMETRICENUM_DEF 1
+/* How the distance between steps of multivariate sequences is measured. */
+enum stepMetric {
+    /* Sum of the absolute differences of each dimension. */
+    METRIC_L1 = 0,
+    /* Square root of the sum of the squared differences. */
+    METRIC_L2 = 1
+};
+#endif
+
+#ifndef DTWCOSTENUM_DEF
+#define DTWCOSTENUM_DEF 1
+/* The cost of matching two steps of the sequences. */
+enum dtwCost {
+    /* |a - b|, or the step distance for multivariate sequences. */
+    COST_ABSOLUTE = 0,
+    /* (a - b)^2, or the step distance squared. */
+    COST_SQUARED = 1
+};
+#endif
+
+#ifndef STEPPATTERNENUM_DEF
+#define STEPPATTERNENUM_DEF 1
+/* How a cell's cost is added to the cheapest of its three neighbours. */
+enum stepPattern {
+    /* Every step adds the cell's cost once. */
+    STEP_SYMMETRIC1 = 0,
+    /* Diagonal steps add the cell's cost times a given weight. */
+    STEP_WEIGHTED_DIAGONAL = 1,
+    /* Diagonal steps add the cell's cost twice. */
+    STEP_SYMMETRIC2 = 2
+};
+#endif
+
+#ifndef WINDOWSHAPEENUM_DEF
+#define WINDOWSHAPEENUM_DEF 1
+/* Which cells of the matrix a Part D problem's window admits. */
+enum windowShape {
+    /* The Sakoe-Chiba band, |i - j| <= window size. */
+    WINDOW_SAKOE_CHIBA = 0,
+    /* A band of the window size around the line from (1, 1) to (n, m), 
+        widened along with the line's slope (see rowRanges.h). */
+    WINDOW_SLANTED_BAND = 1,
+    /* The Itakura parallelogram of a given slope. */
+    WINDOW_ITAKURA = 2,
+    /* Ranges of columns given for each row by setProblemRowRanges. */
+    WINDOW_ROW_RANGES = 3
+};
+#endif
+
+#ifndef SOLVESTRATEGYENUM_DEF
+#define SOLVESTRATEGYENUM_DEF 1
+/* How the cells of the DTW matrix are kept while solving. */
+enum solveStrategy {
+    /* Part A's whole matrix, row by row (solveProblemA). */
+    STRATEGY_FULL_MATRIX = 0,
+    /* Part A's whole matrix, in tiles (solveProblemA with MATRIX_TILES). */
+    STRATEGY_TILED_MATRIX = 1,
+    /* Two rolling rows, only giving the optimal value 
+        (solveProblemADistance or solveProblemDDistance). */
+    STRATEGY_ROLLING_ROWS = 2,
+    /* Part D's window, as a band or row ranges (solveProblemD). */
+    STRATEGY_BAND = 3,
+    /* Part F's two rolling layers (solveProblemF). */
+    STRATEGY_ROLLING_LAYERS = 4
+};
+
+/* The most plans planProblem gives for one problem. */
+#define STRATEGY_COUNT 5
+
+/* What solving a problem with one strategy is expected to cost. */
+struct solvePlan {
+    enum solveStrategy strategy;
+    /* Bytes the solver allocates, besides the sequences themselves. */
+    size_t bytes;
+    /* Rough seconds to solve, from typical costs per cell visited. */
+    double seconds;
+};
+#endif
+
+#ifndef SOLVEOPTIONS_DEF
+#define SOLVEOPTIONS_DEF 1
+/* Solving options given on the command line, see parseSolveOption. */
+struct solveOptions {
+    /* Whether only the optimal value is needed. */
+    int distanceOnly;
+    /* Number of threads to solve with. */
+    int threadCount;
+    /* Precision to solve in. */
+    enum dtwPrecision precision;
+    /* Cost above which solving can stop early. */
+    long double threshold;
+    /* Whether to find the warping path. */
+    int findPath;
+    /* Distance between steps of multivariate sequences. */
+    enum stepMetric metric;
+    /* Cost of matching two steps. */
+    enum dtwCost cost;
+    /* Step pattern of the recurrence, and its diagonal weight. */
+    enum stepPattern step;
+    long double diagonalWeight;
+    /* Bytes solving may use, 0 for the machine's physical memory. */
+    size_t memoryBudget;
+};
+#endif
+
+/* Side length of the tiles of the tiled matrix layout. */
+#define MATRIX_TILE_SIZE 32
+
+/*
+    Reads a sequence of values from the given file, either comma-separated
+    text or a binary sequence file (see sequenceFile.h), setting seq to a 
+    newly allocated array of them and seqLen to their count. Regular files 
+    are mapped with mmap and parsed in place.
+*/
+void readSequence(FILE *seqFile, int *seqLen, long double **seq);
+
+/*
+    Creates a Part A problem over the given sequences. The sequences are
+    not copied, and are left for the caller to free after freeProblem.
+*/
+struct problem *newProblemA(long double *seqA, int seqALength, 
+    long double *seqB, int seqBLength);
+
+/*
+    Same as newProblemA, but for Part D with the given window size.
+*/
+struct problem *newProblemD(long double *seqA, int seqALength, 
+    long double *seqB, int seqBLength, int windowSize);
+
+/*
+    Same as newProblemA, but for Part F with the given maximum path length.
+*/
+struct problem *newProblemF(long double *seqA, int seqALength, 
+    long double *seqB, int seqBLength, int maxPathLength);
+
+/*
+    Points the problem at new sequences, as if it had been created over 
+    them, keeping every other setting. The sequences are not copied, and 
+    any the problem owned are freed. Ranges from setProblemRowRanges are 
+    for the old rows, so the window goes back to the Sakoe-Chiba band. 
+    Together with a workspace, solving many problems this way allocates 
+    nothing once the workspace has grown to the largest.
+*/
+void setProblemSequences(struct problem *p, long double *seqA, 
+    int seqALength, long double *seqB, int seqBLength);
 
 /* 
-    Reads the given sequence files and stores them.
+    Reads the given sequence files and stores them. Binary sequence files of 
+    long doubles are used in place, mapped until freeProblem. Multivariate 
+    sequence files (see sequenceFile.h) set the problem's dimensions, and 
+    must have the same number of values per step.
 */
 struct problem *readProblemA(FILE *seqAFile, FILE *seqBFile);
 
@@ -26,30 +204,277 @@ struct problem *readProblemD(FILE *seqAFile, FILE *seqBFile, int windowSize);
 */
 struct problem *readProblemF(FILE *seqAFile, FILE *seqBFile, int maxPathLength);
 
+/*
+    Sets the number of threads the solvers may use. With more than one 
+    thread, Part A and Part D matrices are computed in tiles along 
+    anti-diagonals by the wavefront engine, and the rows of each Part F 
+    layer are shared out among the threads. Defaults to 1.
+*/
+void setProblemThreadCount(struct problem *p, int threadCount);
+
+/*
+    Sets the precision the solvers compute in. For Part A and Part D, double 
+    and float are computed along anti-diagonals with SSE/AVX2 vector kernels 
+    (single-threaded) and widened back to long double in the solution. For 
+    Part F, each row of a layer is one vector kernel, multi-threaded with 
+    setProblemThreadCount. Defaults to PRECISION_LONG_DOUBLE.
+
+    Whatever the precision, single-threaded Part A and Part D problems over 
+    whole numbers, whose costliest possible path fits in a 16 or 32-bit 
+    integer, are computed in integers along anti-diagonals instead, giving 
+    exactly the long double solution.
+*/
+void setProblemPrecision(struct problem *p, enum dtwPrecision precision);
+
+/*
+    Sets a cost threshold for the Part A and Part D solvers. Once every cell 
+    of a row (or band row, or two consecutive anti-diagonals for reduced 
+    precision) exceeds it, the solver stops and the solution is marked as 
+    exceeding the threshold. The multi-threaded engine always finishes, but 
+    still marks the solution. Defaults to LDINFINITY, i.e. no threshold.
+*/
+void setProblemThreshold(struct problem *p, long double threshold);
+
+/*
+    Makes the solvers take their memory from the given workspace (see 
+    workspace.h), which is reused from one solve to the next. A solution's 
+    matrix is then only valid until the workspace is next used, and the 
+    workspace must outlive the problem and its solutions. NULL (the 
+    default) allocates fresh memory for each solve.
+
+    The solution itself, its warping path and the engines' working memory 
+    come from the workspace's arena, so once the workspace has grown to 
+    the largest problem solved, single-threaded solves make no heap 
+    allocations (solveProblemDAdaptive still makes a reversed problem).
+*/
+void setProblemWorkspace(struct problem *p, struct workspace *workspace);
+
+/*
+    Sets whether the Part A and Part D solvers also find an optimal warping 
+    path, which outputProblem prints as (i,j) pairs after the solution. The 
+    path is recovered with a divide-and-conquer search using memory linear 
+    in the sequence lengths, so it works with solveProblemADistance too. 
+    Defaults to 0.
+*/
+void setProblemWarpingPath(struct problem *p, int findPath);
+
+/*
+    Sets the number of values per step of the sequences given to newProblemA 
+    or newProblemD, which then hold one run of seqALength or seqBLength 
+    values per dimension. The cost of each cell is then the distance 
+    between steps set by setProblemMetric, computed in double precision 
+    with SSE/AVX2 kernels. Multivariate problems are solved by the 
+    single-threaded long double solvers, ignoring setProblemThreadCount, 
+    setProblemPrecision, setProblemWarpingPath and the tiled layout. 
+    Defaults to 1.
+*/
+void setProblemDimensions(struct problem *p, int dimensions);
+
+/*
+    Sets how the distance between steps of multivariate sequences is 
+    measured. Univariate sequences always cost |a - b|. Defaults to 
+    METRIC_L1.
+*/
+void setProblemMetric(struct problem *p, enum stepMetric metric);
+
+/*
+    Sets the cost of matching two steps. Defaults to COST_ABSOLUTE.
+*/
+void setProblemCost(struct problem *p, enum dtwCost cost);
+
+/*
+    Sets the step pattern of the recurrence, where diagonalWeight is only 
+    used by STEP_WEIGHTED_DIAGONAL. Problems with any cost or step pattern 
+    other than the defaults are solved by the single-threaded long double 
+    solvers, as multivariate problems are (see setProblemDimensions). 
+    Defaults to STEP_SYMMETRIC1.
+*/
+void setProblemStepPattern(struct problem *p, enum stepPattern step, 
+    long double diagonalWeight);
+
+/*
+    Sets the shape of a Part D problem's window, where slope is only used by 
+    WINDOW_ITAKURA and must be at least 1. Shapes other than the default 
+    WINDOW_SAKOE_CHIBA are stored as one range of columns per row, so time 
+    and memory are proportional to the number of cells admitted, and are 
+    solved by the single-threaded long double solver, ignoring 
+    setProblemThreadCount and setProblemPrecision.
+*/
+void setProblemWindowShape(struct problem *p, enum windowShape shape, 
+    long double slope);
+
+/*
+    Sets the window of a Part D problem to columns lo[i - 1] to hi[i - 1] of 
+    each row i from 1 to rowCount, clipped to the matrix, with 
+    lo[i - 1] > hi[i - 1] admitting no cells, as do any rows past rowCount. 
+    The ranges are copied, and the window shape is set to WINDOW_ROW_RANGES.
+*/
+void setProblemRowRanges(struct problem *p, int *lo, int *hi, int rowCount);
+
+/*
+    Sets how solveProblemA lays out its matrix. With MATRIX_TILES the matrix 
+    is computed tile by tile, single-threaded and in long double, taking 
+    precedence over setProblemThreadCount and setProblemPrecision. Defaults 
+    to MATRIX_ROWS.
+*/
+void setProblemMatrixLayout(struct problem *p, enum matrixLayout layout);
+
 /*
     Solves the given problem according to Part A's definition
     and places the solution output into a returned solution value.
 */
 struct solution *solveProblemA(struct problem *p);
 
+/*
+    Solves the given problem according to Part A's definition, but only
+    computes the optimal value using two rolling rows, so memory is linear in
+    the shorter sequence. The returned solution holds no matrix.
+*/
+struct solution *solveProblemADistance(struct problem *p);
+
 /*
     Solves the given problem according to Part B's definition
     and places the solution output into a returned solution value.
 */
 struct solution *solveProblemD(struct problem *p);
 
+/*
+    Same as solveProblemD, but like solveProblemADistance only computes the 
+    optimal value, using two rolling rows, so memory is linear in the 
+    shorter sequence whatever the window size. Windows other than the 
+    Sakoe-Chiba band are solved by solveProblemD instead.
+*/
+struct solution *solveProblemDDistance(struct problem *p);
+
+/*
+    Solves the given Part D problem for the exact, unconstrained Part A 
+    distance, starting from a band of the problem's window size and 
+    doubling it until no path leaving the band can be cheaper than the best 
+    path inside it. The returned solution holds the final band, whose 
+    window size getSolutionWindowSize gives. The window is always a 
+    Sakoe-Chiba band, whatever shape setProblemWindowShape set.
+*/
+struct solution *solveProblemDAdaptive(struct problem *p);
+
 /*
     Solves the given problem according to Part D's definition
     and places the solution output into a returned solution value.
 */
 struct solution *solveProblemF(struct problem *p);
 
+/*
+    Estimates the memory and time of every strategy able to solve the 
+    problem as it is set up (part, window, threads, precision, layout and 
+    so on), writing up to STRATEGY_COUNT plans and returning how many. With 
+    distanceOnly, strategies which only find the optimal value are 
+    included, otherwise only those keeping every cell outputProblem and 
+    outputProblemMatrix print are. Nothing is allocated for the matrix.
+*/
+int planProblem(struct problem *p, int distanceOnly, struct solvePlan *plans);
+
+/*
+    Sets plan to the fastest of planProblem's plans needing at most 
+    memoryBudget bytes, or the machine's physical memory if memoryBudget is 
+    0. Returns 1 if one fits, otherwise returns 0, setting plan to the one 
+    needing the least memory.
+*/
+int chooseProblemPlan(struct problem *p, int distanceOnly, 
+    size_t memoryBudget, struct solvePlan *plan);
+
+/*
+    Solves the problem with the strategy of a plan from planProblem.
+*/
+struct solution *solveProblemPlan(struct problem *p, struct solvePlan *plan);
+
+/*
+    Returns the name of the given strategy, e.g. "rolling rows".
+*/
+const char *getStrategyName(enum solveStrategy strategy);
+
+/*
+    Reads a number of bytes, optionally followed by K, M or G for 
+    kibibytes, mebibytes or gibibytes, e.g. "512M". Returns 0 if the text 
+    isn't a positive number of bytes.
+*/
+size_t parseMemorySize(const char *text);
+
+/*
+    Sets options to the defaults of each setter, as if no flags were given.
+*/
+void initSolveOptions(struct solveOptions *options);
+
+/*
+    Reads the option at argv[*arg] into options if it is one of the flags 
+    whose letters are in accepted, e.g. "tpM" for -t, -p and -M, moving 
+    *arg on to the option's value if it takes one. Returns 1 if it was 
+    read, 0 if it isn't one of those flags, or -1 after printing why to 
+    stderr if its value is missing or unrecognised. The flags are
+
+        -d                                  distance only
+        -t threads
+        -p long|double|float
+        -e threshold
+        -a                                  find the warping path
+        -m l1|l2
+        -c abs|squared
+        -s symmetric1|symmetric2|weighted
+        -w weight
+        -M bytes                            see parseMemorySize
+*/
+int parseSolveOption(int argc, char **argv, int *arg, const char *accepted, 
+    struct solveOptions *options);
+
+/*
+    Sets the thread count, precision, threshold, warping path, metric, 
+    cost and step pattern of options on the problem.
+*/
+void setProblemSolveOptions(struct problem *p, struct solveOptions *options);
+
 /*
     Outputs the given solution to the given file.
 */
 void outputProblem(struct problem *problem, struct solution *solution, 
     FILE *outfileName);
 
+/*
+    Writes the solution's matrix (or band, with cells outside it infinite) 
+    to the given file as a binary matrix file (see sequenceFile.h) of long 
+    doubles, rows 1 to n of columns 1 to m. Returns 0 without writing 
+    anything if the solution holds no matrix.
+*/
+int outputProblemMatrix(struct problem *problem, struct solution *solution, 
+    FILE *outfileName);
+
+/*
+    Returns cell (i, j) of the solution's matrix, whether stored in full, 
+    as a band or as ranges of each row. Cells outside the stored band or 
+    ranges are infinite.
+*/
+long double getSolutionCell(struct solution *solution, int i, int j);
+
+/*
+    Returns the optimal value of the solution, LDINFINITY if unreachable or 
+    abandoned for exceeding the threshold.
+*/
+long double getOptimalValue(struct solution *solution);
+
+/*
+    Returns 1 if the solution's optimal value exceeds the problem's threshold.
+*/
+int solutionExceedsThreshold(struct solution *solution);
+
+/*
+    Points pathI and pathJ at the cells of the solution's warping path, and 
+    returns how many there are, 0 if no path was found.
+*/
+int getSolutionPath(struct solution *solution, int **pathI, int **pathJ);
+
+/*
+    Returns the window size the solution's band covers, 0 if it holds no 
+    band.
+*/
+int getSolutionWindowSize(struct solution *solution);
+
 /*
     Frees the given solution and all memory allocated for it.
 */
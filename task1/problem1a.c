@@ -15,15 +15,101 @@
         values in the expected format (e.g. test_cases/1a-1-seqB.txt):
     
         ./problem1a test_cases/1a-1-seqA.txt test_cases/1a-1-seqB.txt
+    
+    Adding -d after the sequence files only computes the DTW distance, 
+        using memory linear in the shorter sequence instead of the 
+        full matrix, e.g.
+    
+        ./problem1a test_cases/1a-1-seqA.txt test_cases/1a-1-seqB.txt -d
+    
+    Adding -t followed by a number of threads computes the matrix in 
+        parallel along anti-diagonals, e.g.
+    
+        ./problem1a test_cases/1a-1-seqA.txt test_cases/1a-1-seqB.txt -t 4
+    
+    Adding -p followed by long, double or float sets the precision the 
+        DTW recurrence is computed in, e.g.
+    
+        ./problem1a test_cases/1a-1-seqA.txt test_cases/1a-1-seqB.txt -p float
+    
+    Adding -e followed by a cost threshold stops as soon as the DTW 
+        distance is certain to exceed it, printing "exceeds threshold" 
+        instead of the solution, e.g.
+    
+        ./problem1a test_cases/1a-1-seqA.txt test_cases/1a-1-seqB.txt -e 5
+
+    Adding -a also finds an optimal warping path (alignment) using memory 
+        linear in the sequence lengths, printing its (i,j) cells in order 
+        after the solution, e.g.
+    
+        ./problem1a test_cases/1a-1-seqA.txt test_cases/1a-1-seqB.txt -a
+
+    Adding -b followed by a file name also writes the matrix to that file 
+        as a binary matrix file of long doubles (see sequenceFile.h), e.g.
+    
+        ./problem1a test_cases/1a-1-seqA.txt test_cases/1a-1-seqB.txt -b matrix.bin
+
+    Adding -l followed by rows or tiles sets how the matrix is laid out in 
+        memory, tiles computing it one cache-sized tile at a time, e.g.
+    
+        ./problem1a test_cases/1a-1-seqA.txt test_cases/1a-1-seqB.txt -l tiles
+
+    Sequence files with a dimensions header and a line per dimension (or 
+        binary files with more than one dimension, see sequenceFile.h) 
+        give multivariate DTW, where adding -m followed by l1 or l2 sets 
+        the distance between steps, e.g.
+    
+        ./problem1a test_cases/1a-1-seqA.txt test_cases/1a-1-seqB.txt -m l2
+
+    Adding -c followed by abs or squared sets the cost of matching two 
+        values, |a - b| or (a - b)^2, and adding -s followed by 
+        symmetric1, symmetric2 or weighted sets the step pattern, where 
+        diagonal steps add the cost once, twice, or times the weight given 
+        after -w (1 by default), e.g.
+    
+        ./problem1a test_cases/1a-1-seqA.txt test_cases/1a-1-seqB.txt -c squared -s weighted -w 1.5
+
+    Adding -M followed by a number of bytes (with an optional K, M or G 
+        suffix) picks the fastest way of solving which fits in that much 
+        memory, reporting it on stderr, and fails if none does. Without it, 
+        the budget is the machine's physical memory, e.g.
+    
+        ./problem1a test_cases/1a-1-seqA.txt test_cases/1a-1-seqB.txt -d -M 64M
+
+    Adding -f follows seqB as it grows, like tail -f, keeping only the last 
+        column of the matrix against seqA. Each time complete values 
+        (followed by a comma or newline) are appended, the length of seqB 
+        so far and the DTW distance are printed. A seqB of - follows stdin 
+        until it ends, any other file is followed until interrupted. Only 
+        -c, -s and -w apply, e.g.
+    
+        tail -f live.txt | ./problem1a test_cases/1a-1-seqA.txt - -f
 */
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <string.h>
 //#include <error.h>
 #include "problem.h"
+#include "sequenceStream.h"
+#include "onlineDTW.h"
 
 #define SEQ_A_ARG 1
 #define SEQ_B_ARG 2
+#define FLAGS_START_ARG 3
+
+#define MATRIX_FLAG "-b"
+#define LAYOUT_FLAG "-l"
+#define FOLLOW_FLAG "-f"
+/* Letters of the flags parseSolveOption reads. */
+#define SOLVE_OPTIONS "dtpeamcswM"
+
+/*
+    Follows the sequence in the given file (or stdin) as it grows, printing 
+    its length and its DTW distance to the template whenever values are 
+    appended. Returns the program's exit status.
+*/
+int followSequence(struct onlineDTW *o, char *fileName);
 
 int main(int argc, char **argv){
     struct problem *problem;
@@ -32,13 +118,56 @@ int main(int argc, char **argv){
     FILE *seqAFile = NULL;
     /* Load file with second sequence from argv[2]. */
     FILE *seqBFile = NULL;
+    /* Options shared with the other drivers. */
+    struct solveOptions options;
+    /* File to write the binary matrix to, if any. */
+    char *matrixFileName = NULL;
+    /* Layout of the matrix in memory. */
+    enum matrixLayout layout = MATRIX_ROWS;
+    /* Whether to follow seqB as it grows. */
+    int follow = 0;
+    /* How the problem is solved. */
+    struct solvePlan plan;
 
     if(argc < 3){
         fprintf(stderr, "You only gave %d arguments to the program, \n"
             "you should run the program with in the form \n"
-            "\t./problem1a seqA seqB\n", argc);
+            "\t./problem1a seqA seqB [-d] [-t threads] [-p long|double|float]\n"
+            "\t\t[-e threshold] [-a] [-b matrix_file] [-l rows|tiles]\n"
+            "\t\t[-m l1|l2] [-c abs|squared] [-s symmetric1|symmetric2|weighted]\n"
+            "\t\t[-w weight] [-M bytes] [-f]\n", argc);
         return EXIT_FAILURE;
     } 
+
+    initSolveOptions(&options);
+    for(int arg = FLAGS_START_ARG; arg < argc; arg++){
+        int read = parseSolveOption(argc, argv, &arg, SOLVE_OPTIONS, 
+            &options);
+        if(read < 0){
+            return EXIT_FAILURE;
+        } else if(read){
+            continue;
+        }
+        if(strcmp(argv[arg], MATRIX_FLAG) == 0 && arg + 1 < argc){
+            arg++;
+            matrixFileName = argv[arg];
+        } else if(strcmp(argv[arg], LAYOUT_FLAG) == 0 && arg + 1 < argc){
+            arg++;
+            if(strcmp(argv[arg], "rows") == 0){
+                layout = MATRIX_ROWS;
+            } else if(strcmp(argv[arg], "tiles") == 0){
+                layout = MATRIX_TILES;
+            } else {
+                fprintf(stderr, "Unrecognised layout \"%s\"\n", argv[arg]);
+                return EXIT_FAILURE;
+            }
+        } else if(strcmp(argv[arg], FOLLOW_FLAG) == 0){
+            follow = 1;
+        } else {
+            fprintf(stderr, "Unrecognised option \"%s\"\n", argv[arg]);
+            return EXIT_FAILURE;
+        }
+    }
     
     /* Attempt to open dictionary and board files. */
     seqAFile = fopen(argv[SEQ_A_ARG], "r");
@@ -49,6 +178,19 @@ int main(int argc, char **argv){
         return EXIT_FAILURE;
     }
 
+    if(follow){
+        long double *template;
+        int templateLength;
+        readSequence(seqAFile, &templateLength, &template);
+        fclose(seqAFile);
+        struct onlineDTW *o = newOnlineDTW(template, templateLength, 
+            options.cost, options.step, options.diagonalWeight);
+        int status = followSequence(o, argv[SEQ_B_ARG]);
+        freeOnlineDTW(o);
+        free(template);
+        return status;
+    }
+
     seqBFile = fopen(argv[SEQ_B_ARG], "r");
     if(! seqBFile){
         fprintf(stderr, "File given as board file was \"%s\", "
@@ -68,13 +210,66 @@ int main(int argc, char **argv){
         fclose(seqBFile);
     }
 
-    solution = solveProblemA(problem);
+    setProblemSolveOptions(problem, &options);
+    setProblemMatrixLayout(problem, layout);
+
+    if(! chooseProblemPlan(problem, options.distanceOnly, 
+        options.memoryBudget, &plan)){
+        fprintf(stderr, "Solving needs at least %zu bytes with %s, "
+            "more than the memory budget\n", plan.bytes, 
+            getStrategyName(plan.strategy));
+        freeProblem(problem);
+        return EXIT_FAILURE;
+    }
+    if(options.memoryBudget){
+        fprintf(stderr, "Solving with %s, about %zu bytes and %.3g s\n", 
+            getStrategyName(plan.strategy), plan.bytes, plan.seconds);
+    }
+    solution = solveProblemPlan(problem, &plan);
 
     outputProblem(problem, solution, stdout);
 
+    if(matrixFileName){
+        FILE *matrixFile = fopen(matrixFileName, "wb");
+        if(! matrixFile){
+            fprintf(stderr, "File given as matrix file was \"%s\", "
+                "which was unable to be opened\n", matrixFileName);
+            perror("Reason for file open failure");
+        } else {
+            if(! outputProblemMatrix(problem, solution, matrixFile)){
+                fprintf(stderr, "No matrix to write to \"%s\"\n", 
+                    matrixFileName);
+            }
+            fclose(matrixFile);
+        }
+    }
+
     freeSolution(solution, problem);
 
     freeProblem(problem);
 
     return EXIT_SUCCESS;
 }
+
+int followSequence(struct onlineDTW *o, char *fileName){
+    struct sequenceStream *stream = openSequenceStream(fileName, 1);
+    if(! stream){
+        fprintf(stderr, "File given as board file was \"%s\", "
+            "which was unable to be opened\n", fileName);
+        perror("Reason for file open failure");
+        return EXIT_FAILURE;
+    }
+
+    long double *values;
+    int count;
+    while((count = readSequenceStream(stream, &values)) > 0){
+        appendOnlineDTW(o, values, count);
+        free(values);
+        printf("%d %.2Lf\n", getOnlineLength(o), getOnlineDistance(o));
+        fflush(stdout);
+    }
+
+    closeSequenceStream(stream);
+
+    return EXIT_SUCCESS;
+}
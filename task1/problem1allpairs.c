@@ -0,0 +1,256 @@
+/*
+    Make using
+        make problem1allpairs
+
+    Run using
+        ./problem1allpairs sequences [-w window_size] [-j threads] 
+            [-b matrix_file]
+
+    where sequences is either a directory of sequence files or a manifest
+        file listing one sequence file per line (lines starting with # are
+        skipped), for example:
+
+        ./problem1allpairs test_cases -j 4
+
+    Every sequence is read once, and the DTW distance between every pair is
+        printed as a matrix, one comma-separated line per sequence, in
+        manifest order (or name order for a directory). The distances are 
+        unconstrained as in Part A, or windowed as in Part D with -w. The 
+        pairs are shared out among the threads (1 by default), which take 
+        work from each other as they run out.
+
+    Adding -b followed by a file name writes the matrix to that file as a 
+        binary matrix file of long doubles (see sequenceFile.h) instead, 
+        e.g.
+
+        ./problem1allpairs test_cases -j 4 -b distances.bin
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "problem.h"
+#include "sequenceFile.h"
+#include "allPairs.h"
+
+#define SEQUENCES_ARG 1
+#define FLAGS_START_ARG 2
+
+#define WINDOW_FLAG "-w"
+#define THREADS_FLAG "-j"
+#define MATRIX_FLAG "-b"
+#define NUMBER_BASE (10)
+
+#define MANIFEST_COMMENT '#'
+
+/* Every sequence read, in order. */
+struct sequenceSet {
+    long double **sequences;
+    int *lengths;
+    int count;
+    int allocated;
+};
+
+/* Reads the sequence in the given file and adds it to the set. */
+void addFile(struct sequenceSet *set, char *fileName);
+
+/* Adds every regular file in the given directory, in name order. */
+void addDirectory(struct sequenceSet *set, char *directoryName);
+
+/* Adds every file listed in the given manifest. */
+void addManifest(struct sequenceSet *set, FILE *manifest);
+
+/* Writes the count by count matrix of distances as comma-separated text, 
+    with inf for pairs too different in length for the window. */
+void writeTextMatrix(FILE *out, long double *distances, int count);
+
+/* Writes the count by count matrix of distances as a binary matrix file. */
+void writeBinaryMatrix(FILE *out, long double *distances, int count);
+
+int main(int argc, char **argv){
+    int windowSize = -1;
+    int threadCount = 1;
+    char *matrixFileName = NULL;
+
+    if(argc < 2){
+        fprintf(stderr, "You only gave %d arguments to the program, \n"
+            "you should run the program with in the form \n"
+            "\t./problem1allpairs sequences [-w window_size] [-j threads]\n"
+            "\t\t[-b matrix_file]\n", argc);
+        return EXIT_FAILURE;
+    }
+
+    for(int arg = FLAGS_START_ARG; arg < argc; arg++){
+        if(strcmp(argv[arg], WINDOW_FLAG) == 0 && arg + 1 < argc){
+            arg++;
+            windowSize = strtol(argv[arg], NULL, NUMBER_BASE);
+        } else if(strcmp(argv[arg], THREADS_FLAG) == 0 && arg + 1 < argc){
+            arg++;
+            threadCount = strtol(argv[arg], NULL, NUMBER_BASE);
+        } else if(strcmp(argv[arg], MATRIX_FLAG) == 0 && arg + 1 < argc){
+            arg++;
+            matrixFileName = argv[arg];
+        } else {
+            fprintf(stderr, "Unrecognised option \"%s\"\n", argv[arg]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    struct sequenceSet set = {NULL, NULL, 0, 0};
+    struct stat sequencesStat;
+    if(stat(argv[SEQUENCES_ARG], &sequencesStat) != 0){
+        fprintf(stderr, "Sequences given as \"%s\", which was unable to "
+            "be found\n", argv[SEQUENCES_ARG]);
+        perror("Reason for failure");
+        return EXIT_FAILURE;
+    }
+    if(S_ISDIR(sequencesStat.st_mode)){
+        addDirectory(&set, argv[SEQUENCES_ARG]);
+    } else {
+        FILE *manifest = fopen(argv[SEQUENCES_ARG], "r");
+        if(! manifest){
+            fprintf(stderr, "File given as manifest file was \"%s\", "
+                "which was unable to be opened\n", argv[SEQUENCES_ARG]);
+            perror("Reason for file open failure");
+            return EXIT_FAILURE;
+        }
+        addManifest(&set, manifest);
+        fclose(manifest);
+    }
+
+    long double *distances = (long double *) malloc(sizeof(long double) * 
+        set.count * set.count);
+    assert(distances || set.count == 0);
+    struct allPairsStats stats = allPairsDTW(set.sequences, set.lengths, 
+        set.count, windowSize, threadCount, distances);
+
+    if(matrixFileName){
+        FILE *matrixFile = fopen(matrixFileName, "wb");
+        if(! matrixFile){
+            fprintf(stderr, "File given as matrix file was \"%s\", "
+                "which was unable to be opened\n", matrixFileName);
+            perror("Reason for file open failure");
+            return EXIT_FAILURE;
+        }
+        writeBinaryMatrix(matrixFile, distances, set.count);
+        fclose(matrixFile);
+    } else {
+        writeTextMatrix(stdout, distances, set.count);
+    }
+    fprintf(stderr, "sequences: %d, pairs solved: %lld, steals: %lld\n", 
+        set.count, stats.pairs, stats.steals);
+
+    for(int i = 0; i < set.count; i++){
+        free(set.sequences[i]);
+    }
+    free(set.sequences);
+    free(set.lengths);
+    free(distances);
+
+    return EXIT_SUCCESS;
+}
+
+void addFile(struct sequenceSet *set, char *fileName){
+    FILE *seqFile = fopen(fileName, "r");
+    if(! seqFile){
+        fprintf(stderr, "Skipping sequence \"%s\", which was unable to be "
+            "opened\n", fileName);
+        return;
+    }
+    if(set->count == set->allocated){
+        set->allocated = set->allocated ? 2 * set->allocated : 64;
+        set->sequences = (long double **) realloc(set->sequences, 
+            sizeof(long double *) * set->allocated);
+        assert(set->sequences);
+        set->lengths = (int *) realloc(set->lengths, 
+            sizeof(int) * set->allocated);
+        assert(set->lengths);
+    }
+    readSequence(seqFile, &(set->lengths[set->count]), 
+        &(set->sequences[set->count]));
+    fclose(seqFile);
+    set->count++;
+}
+
+void addDirectory(struct sequenceSet *set, char *directoryName){
+    struct dirent **entries;
+    int entryCount = scandir(directoryName, &entries, NULL, alphasort);
+    if(entryCount < 0){
+        perror("Encountered error reading sequence directory");
+        exit(EXIT_FAILURE);
+    }
+    for(int i = 0; i < entryCount; i++){
+        char *path = (char *) malloc(strlen(directoryName) +
+            strlen(entries[i]->d_name) + 2);
+        assert(path);
+        sprintf(path, "%s/%s", directoryName, entries[i]->d_name);
+        struct stat entryStat;
+        if(entries[i]->d_name[0] != '.' && stat(path, &entryStat) == 0 &&
+            S_ISREG(entryStat.st_mode)){
+            addFile(set, path);
+        }
+        free(path);
+        free(entries[i]);
+    }
+    free(entries);
+}
+
+void addManifest(struct sequenceSet *set, FILE *manifest){
+    char *line = NULL;
+    size_t allocated = 0;
+    ssize_t lineLength;
+    while((lineLength = getline(&line, &allocated, manifest)) != -1){
+        /* Trim the newline and any trailing whitespace. */
+        while(lineLength > 0 && (line[lineLength - 1] == '\n' ||
+            line[lineLength - 1] == '\r' || line[lineLength - 1] == ' ')){
+            line[--lineLength] = '\0';
+        }
+        if(lineLength == 0 || line[0] == MANIFEST_COMMENT){
+            continue;
+        }
+        addFile(set, line);
+    }
+    free(line);
+}
+
+void writeTextMatrix(FILE *out, long double *distances, int count){
+    for(int i = 0; i < count; i++){
+        for(int j = 0; j < count; j++){
+            long double distance = distances[(size_t) i * count + j];
+            if(j > 0){
+                fprintf(out, ",");
+            }
+            /* No warping path fits the window. */
+            if(distance >= LDINFINITY){
+                fprintf(out, "inf");
+            } else {
+                fprintf(out, "%.2Lf", distance);
+            }
+        }
+        fprintf(out, "\n");
+    }
+}
+
+void writeBinaryMatrix(FILE *out, long double *distances, int count){
+    struct matrixFileHeader header;
+    memset(&header, 0, sizeof(struct matrixFileHeader));
+    memcpy(header.magic, MATRIX_FILE_MAGIC, SEQUENCE_FILE_MAGIC_SIZE);
+    header.elementType = SEQUENCE_LONG_DOUBLE;
+    header.elementSize = sizeof(long double);
+    header.rows = count;
+    header.columns = count;
+    fwrite(&header, sizeof(struct matrixFileHeader), 1, out);
+
+    /* Write a row at a time, with unused bytes of each value zeroed. */
+    long double *row = (long double *) calloc(count, sizeof(long double));
+    assert(row || count == 0);
+    for(int i = 0; i < count; i++){
+        for(int j = 0; j < count; j++){
+            row[j] = distances[(size_t) i * count + j];
+        }
+        fwrite(row, sizeof(long double), count, out);
+    }
+    free(row);
+}
@@ -0,0 +1,145 @@
+/*
+    Make using
+        make problem1approx
+
+    Run using
+        ./problem1approx seqA seqB radius [-c] [-a]
+
+    where seqA and seqB are the names of the files with the sequences in
+        the expected format (e.g. test_cases/1a-1-seqA.txt), and radius is
+        how far around each projected path FastDTW refines, for example:
+
+        ./problem1approx test_cases/1a-1-seqA.txt test_cases/1a-1-seqB.txt 1
+
+    The approximate Part A DTW cost is printed with the time it took and
+        the number of matrix cells computed, against the n * m cells of
+        the exact DTW.
+
+    Adding -c also computes the exact cost (as with problem1a -d), to
+        print the error of the approximation and the speedup over it, e.g.
+
+        ./problem1approx test_cases/1a-1-seqA.txt test_cases/1a-1-seqB.txt 1 -c
+
+    Adding -a also prints the approximate warping path's (i,j) cells in
+        order.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <time.h>
+#include "problem.h"
+#include "fastDTW.h"
+
+#define SEQ_A_ARG 1
+#define SEQ_B_ARG 2
+#define RADIUS_ARG 3
+#define FLAGS_START_ARG 4
+
+#define EXACT_FLAG "-c"
+#define PATH_FLAG "-a"
+#define NUMBER_BASE (10)
+
+/* Returns the seconds since an arbitrary point, for timing. */
+double secondsNow(void);
+
+/* Reads the sequence in the given file, exiting if it can't be opened. */
+void readSequenceFile(char *fileName, int *seqLen, long double **seq);
+
+int main(int argc, char **argv){
+    /* Whether to also compute the exact cost. */
+    int exact = 0;
+    /* Whether to print the path. */
+    int printPath = 0;
+
+    if(argc < 4){
+        fprintf(stderr, "You only gave %d arguments to the program, \n"
+            "you should run the program with in the form \n"
+            "\t./problem1approx seqA seqB radius [-c] [-a]\n", argc);
+        return EXIT_FAILURE;
+    }
+
+    for(int arg = FLAGS_START_ARG; arg < argc; arg++){
+        if(strcmp(argv[arg], EXACT_FLAG) == 0){
+            exact = 1;
+        } else if(strcmp(argv[arg], PATH_FLAG) == 0){
+            printPath = 1;
+        } else {
+            fprintf(stderr, "Unrecognised option \"%s\"\n", argv[arg]);
+            return EXIT_FAILURE;
+        }
+    }
+    int radius = strtol(argv[RADIUS_ARG], NULL, NUMBER_BASE);
+
+    int seqALength, seqBLength;
+    long double *seqA, *seqB;
+    readSequenceFile(argv[SEQ_A_ARG], &seqALength, &seqA);
+    readSequenceFile(argv[SEQ_B_ARG], &seqBLength, &seqB);
+
+    int *pathI = (int *) malloc(sizeof(int) * (seqALength + seqBLength - 1));
+    assert(pathI);
+    int *pathJ = (int *) malloc(sizeof(int) * (seqALength + seqBLength - 1));
+    assert(pathJ);
+    int pathLength;
+    long long cellsComputed = 0;
+
+    double start = secondsNow();
+    long double approximate = fastDTW(seqA, seqALength, seqB, seqBLength,
+        radius, pathI, pathJ, &pathLength, &cellsComputed);
+    double approximateTime = secondsNow() - start;
+
+    long long allCells = (long long) seqALength * seqBLength;
+    printf("approximate: %.2Lf in %.6f s\n", approximate, approximateTime);
+    printf("cells computed: %lld of %lld (%.2fx fewer)\n", cellsComputed,
+        allCells, (double) allCells / cellsComputed);
+
+    if(exact){
+        struct problem *problem = newProblemA(seqA, seqALength, seqB,
+            seqBLength);
+        start = secondsNow();
+        struct solution *solution = solveProblemADistance(problem);
+        double exactTime = secondsNow() - start;
+        long double exactCost = getOptimalValue(solution);
+        printf("exact: %.2Lf in %.6f s\n", exactCost, exactTime);
+        if(exactCost > 0){
+            printf("error: %.4Lf%%\n",
+                100 * (approximate - exactCost) / exactCost);
+        } else {
+            printf("error: %.2Lf\n", approximate - exactCost);
+        }
+        printf("speedup: %.2fx\n", exactTime / approximateTime);
+        freeSolution(solution, problem);
+        freeProblem(problem);
+    }
+
+    if(printPath){
+        for(int k = 0; k < pathLength; k++){
+            printf("(%d,%d)\n", pathI[k], pathJ[k]);
+        }
+    }
+
+    free(pathI);
+    free(pathJ);
+    free(seqA);
+    free(seqB);
+
+    return EXIT_SUCCESS;
+}
+
+double secondsNow(void){
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+void readSequenceFile(char *fileName, int *seqLen, long double **seq){
+    FILE *seqFile = fopen(fileName, "r");
+    if(! seqFile){
+        fprintf(stderr, "File given as sequence file was \"%s\", "
+            "which was unable to be opened\n", fileName);
+        perror("Reason for file open failure");
+        exit(EXIT_FAILURE);
+    }
+    readSequence(seqFile, seqLen, seq);
+    fclose(seqFile);
+}
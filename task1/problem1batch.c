@@ -0,0 +1,409 @@
+/*
+    Make using
+        make problem1batch
+
+    Run using
+        ./problem1batch manifest [-j threads]
+
+    where manifest is a file of jobs in the same format as
+        test_case_runlist, one per line, e.g.
+
+        ./problem1a test_cases/1a-1-seqA.txt test_cases/1a-1-seqB.txt
+        ./problem1d test_cases/1d-1-seqA.txt test_cases/1d-1-seqB.txt 3
+
+    A line may end with any of the flags its program shares with the 
+        others, -d, -t, -p, -e, -a, -m, -c, -s, -w and -M (see 
+        parseSolveOption in problem.h), as far as that program accepts 
+        them, and problem1d lines may also end with -x. Lines with any 
+        other flag are skipped with a message, as are 
+        lines starting with # and blank lines. Each job's output is exactly 
+        what running its line would print, written in manifest order, e.g.
+
+        ./problem1batch test_case_runlist -j 4
+
+    Jobs are shared out among the threads (1 by default), each of which
+        keeps a workspace that its solves reuse from one job to the next.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <pthread.h>
+#include "problem.h"
+#include "workspace.h"
+
+#define MANIFEST_ARG 1
+#define FLAGS_START_ARG 2
+
+#define THREADS_FLAG "-j"
+#define NUMBER_BASE (10)
+
+#define MANIFEST_COMMENT '#'
+#define JOB_TOKEN_DELIMITERS " \t\r\n"
+
+/* Letters of the flags each program reads with parseSolveOption, as 
+    problem1a, problem1d and problem1f do. */
+#define JOB_A_OPTIONS "dtpeamcswM"
+#define JOB_D_OPTIONS "tpeamcswM"
+#define JOB_F_OPTIONS "tpmcswM"
+/* Widens a Part D job's window until its distance is exact. */
+#define ADAPTIVE_FLAG "-x"
+
+/* How many finished jobs may wait to be written per thread before
+    threads stop taking new jobs. */
+#define PENDING_JOBS_PER_THREAD 64
+
+/* Which program a manifest line runs. */
+enum jobKind {
+    JOB_A = 0,
+    JOB_D = 1,
+    JOB_F = 2
+};
+
+/* One line of the manifest. */
+struct job {
+    enum jobKind kind;
+    char *seqAFileName;
+    char *seqBFileName;
+    /* Window size for Part D, maximum path length for Part F. */
+    int parameter;
+    /* The flags at the end of the line. */
+    struct solveOptions options;
+    int adaptive;
+    /* The job's output once run, NULL until then. */
+    char *output;
+    size_t outputLength;
+};
+
+/* Everything shared by the threads running the jobs. */
+struct batch {
+    struct job *jobs;
+    int jobCount;
+    int threadCount;
+    /* The next job to run, and the next to be written. */
+    int nextJob;
+    int nextOutput;
+    pthread_mutex_t lock;
+    /* Signalled when a job finishes, and when a job's output is written. */
+    pthread_cond_t jobFinished;
+    pthread_cond_t outputWritten;
+};
+
+/* Whether the given text ends with the given suffix. */
+int endsWith(char *text, char *suffix);
+
+/* Reads the manifest's jobs, returning how many there are. */
+int readManifest(FILE *manifest, struct job **jobs);
+
+/*
+    Runs the given job, setting output to what it prints, which is empty if
+    its sequence files could not be opened or it needs more memory than 
+    its budget.
+*/
+void runJob(struct job *job, struct workspace *workspace, char **output,
+    size_t *outputLength);
+
+/* Runs jobs until there are none left. */
+void *batchWorker(void *arg);
+
+int main(int argc, char **argv){
+    int threadCount = 1;
+
+    if(argc < 2){
+        fprintf(stderr, "You only gave %d arguments to the program, \n"
+            "you should run the program with in the form \n"
+            "\t./problem1batch manifest [-j threads]\n", argc);
+        return EXIT_FAILURE;
+    }
+
+    for(int arg = FLAGS_START_ARG; arg < argc; arg++){
+        if(strcmp(argv[arg], THREADS_FLAG) == 0 && arg + 1 < argc){
+            arg++;
+            threadCount = strtol(argv[arg], NULL, NUMBER_BASE);
+        } else {
+            fprintf(stderr, "Unrecognised option \"%s\"\n", argv[arg]);
+            return EXIT_FAILURE;
+        }
+    }
+    if(threadCount < 1){
+        threadCount = 1;
+    }
+
+    FILE *manifest = fopen(argv[MANIFEST_ARG], "r");
+    if(! manifest){
+        fprintf(stderr, "File given as manifest file was \"%s\", "
+            "which was unable to be opened\n", argv[MANIFEST_ARG]);
+        perror("Reason for file open failure");
+        return EXIT_FAILURE;
+    }
+
+    struct batch b;
+    b.jobCount = readManifest(manifest, &(b.jobs));
+    fclose(manifest);
+    b.threadCount = threadCount;
+    b.nextJob = 0;
+    b.nextOutput = 0;
+    pthread_mutex_init(&(b.lock), NULL);
+    pthread_cond_init(&(b.jobFinished), NULL);
+    pthread_cond_init(&(b.outputWritten), NULL);
+
+    pthread_t *threads = (pthread_t *) malloc(sizeof(pthread_t) * threadCount);
+    assert(threads);
+    for(int t = 0; t < threadCount; t++){
+        int status = pthread_create(&threads[t], NULL, batchWorker, &b);
+        assert(status == 0);
+    }
+
+    /* Write each job's output as soon as it and every job before it is done. */
+    pthread_mutex_lock(&(b.lock));
+    while(b.nextOutput < b.jobCount){
+        struct job *job = &(b.jobs[b.nextOutput]);
+        while(! job->output){
+            pthread_cond_wait(&(b.jobFinished), &(b.lock));
+        }
+        pthread_mutex_unlock(&(b.lock));
+        fwrite(job->output, 1, job->outputLength, stdout);
+        free(job->output);
+        job->output = NULL;
+        pthread_mutex_lock(&(b.lock));
+        b.nextOutput++;
+        pthread_cond_broadcast(&(b.outputWritten));
+    }
+    pthread_mutex_unlock(&(b.lock));
+
+    for(int t = 0; t < threadCount; t++){
+        pthread_join(threads[t], NULL);
+    }
+    free(threads);
+
+    for(int i = 0; i < b.jobCount; i++){
+        free(b.jobs[i].seqAFileName);
+        free(b.jobs[i].seqBFileName);
+    }
+    free(b.jobs);
+    pthread_cond_destroy(&(b.outputWritten));
+    pthread_cond_destroy(&(b.jobFinished));
+    pthread_mutex_destroy(&(b.lock));
+
+    return EXIT_SUCCESS;
+}
+
+int endsWith(char *text, char *suffix){
+    size_t textLength = strlen(text);
+    size_t suffixLength = strlen(suffix);
+    return textLength >= suffixLength &&
+        strcmp(text + textLength - suffixLength, suffix) == 0;
+}
+
+int readManifest(FILE *manifest, struct job **jobs){
+    int jobCount = 0;
+    int jobsAllocated = 0;
+    struct job *jobList = NULL;
+    char *line = NULL;
+    size_t allocated = 0;
+    int lineNumber = 0;
+    /* The flags of the current line. */
+    char **args = NULL;
+    int argCount = 0;
+    int argsAllocated = 0;
+
+    while(getline(&line, &allocated, manifest) != -1){
+        lineNumber++;
+        char *program = strtok(line, JOB_TOKEN_DELIMITERS);
+        if(! program || program[0] == MANIFEST_COMMENT){
+            continue;
+        }
+        char *seqA = strtok(NULL, JOB_TOKEN_DELIMITERS);
+        char *seqB = strtok(NULL, JOB_TOKEN_DELIMITERS);
+
+        /* The program is recognised by the end of its name. */
+        enum jobKind kind;
+        char *accepted;
+        if(endsWith(program, "problem1a")){
+            kind = JOB_A;
+            accepted = JOB_A_OPTIONS;
+        } else if(endsWith(program, "problem1d")){
+            kind = JOB_D;
+            accepted = JOB_D_OPTIONS;
+        } else if(endsWith(program, "problem1f")){
+            kind = JOB_F;
+            accepted = JOB_F_OPTIONS;
+        } else {
+            fprintf(stderr, "Skipping manifest line %d, unknown program "
+                "\"%s\"\n", lineNumber, program);
+            continue;
+        }
+        char *parameter = (kind != JOB_A) ? 
+            strtok(NULL, JOB_TOKEN_DELIMITERS) : NULL;
+        if(! seqA || ! seqB || (kind != JOB_A && ! parameter)){
+            fprintf(stderr, "Skipping manifest line %d, missing arguments\n",
+                lineNumber);
+            continue;
+        }
+
+        /* The rest of the line is flags, read as the program would. */
+        argCount = 0;
+        char *token;
+        while((token = strtok(NULL, JOB_TOKEN_DELIMITERS))){
+            if(argCount == argsAllocated){
+                argsAllocated = argsAllocated ? 2 * argsAllocated : 16;
+                args = (char **) realloc(args, sizeof(char *) * argsAllocated);
+                assert(args);
+            }
+            args[argCount++] = token;
+        }
+        struct solveOptions options;
+        initSolveOptions(&options);
+        int adaptive = 0;
+        int valid = 1;
+        for(int arg = 0; arg < argCount && valid; arg++){
+            if(kind == JOB_D && strcmp(args[arg], ADAPTIVE_FLAG) == 0){
+                adaptive = 1;
+                continue;
+            }
+            int read = parseSolveOption(argCount, args, &arg, accepted, 
+                &options);
+            if(read == 0){
+                fprintf(stderr, "Unrecognised option \"%s\"\n", args[arg]);
+            }
+            valid = (read == 1);
+        }
+        if(! valid){
+            fprintf(stderr, "Skipping manifest line %d, invalid flags for "
+                "%s\n", lineNumber, program);
+            continue;
+        }
+
+        if(jobCount == jobsAllocated){
+            jobsAllocated = jobsAllocated ? 2 * jobsAllocated : 64;
+            jobList = (struct job *) realloc(jobList,
+                sizeof(struct job) * jobsAllocated);
+            assert(jobList);
+        }
+        struct job *job = &jobList[jobCount++];
+        job->kind = kind;
+        job->seqAFileName = (char *) malloc(strlen(seqA) + 1);
+        assert(job->seqAFileName);
+        strcpy(job->seqAFileName, seqA);
+        job->seqBFileName = (char *) malloc(strlen(seqB) + 1);
+        assert(job->seqBFileName);
+        strcpy(job->seqBFileName, seqB);
+        job->parameter = parameter ? strtol(parameter, NULL, NUMBER_BASE) : 0;
+        job->options = options;
+        job->adaptive = adaptive;
+        job->output = NULL;
+        job->outputLength = 0;
+    }
+    free(line);
+    free(args);
+
+    *jobs = jobList;
+    return jobCount;
+}
+
+void runJob(struct job *job, struct workspace *workspace, char **output,
+    size_t *outputLength){
+    FILE *out = open_memstream(output, outputLength);
+    assert(out);
+
+    FILE *seqAFile = fopen(job->seqAFileName, "r");
+    FILE *seqBFile = fopen(job->seqBFileName, "r");
+    if(! seqAFile || ! seqBFile){
+        fprintf(stderr, "Skipping job with \"%s\" and \"%s\", which were "
+            "unable to be opened\n", job->seqAFileName, job->seqBFileName);
+        if(seqAFile){
+            fclose(seqAFile);
+        }
+        if(seqBFile){
+            fclose(seqBFile);
+        }
+        fclose(out);
+        return;
+    }
+
+    struct problem *problem;
+    switch(job->kind){
+        case JOB_D:
+            problem = readProblemD(seqAFile, seqBFile, job->parameter);
+            break;
+        case JOB_F:
+            problem = readProblemF(seqAFile, seqBFile, job->parameter);
+            break;
+        case JOB_A:
+        default:
+            problem = readProblemA(seqAFile, seqBFile);
+            break;
+    }
+    fclose(seqAFile);
+    fclose(seqBFile);
+
+    setProblemWorkspace(problem, workspace);
+    setProblemSolveOptions(problem, &(job->options));
+
+    if(job->adaptive){
+        struct solution *solution = solveProblemDAdaptive(problem);
+        outputProblem(problem, solution, out);
+        fprintf(out, "window size: %d\n", getSolutionWindowSize(solution));
+        freeSolution(solution, problem);
+        freeProblem(problem);
+        fclose(out);
+        return;
+    }
+
+    /* Only Part A prints the matrix, unless asked for the distance only. */
+    struct solvePlan plan;
+    if(! chooseProblemPlan(problem, job->kind != JOB_A || 
+        job->options.distanceOnly, job->options.memoryBudget, &plan)){
+        fprintf(stderr, "Solving needs at least %zu bytes with %s, "
+            "more than the memory budget\n", plan.bytes, 
+            getStrategyName(plan.strategy));
+        freeProblem(problem);
+        fclose(out);
+        return;
+    }
+    if(job->options.memoryBudget){
+        fprintf(stderr, "Solving with %s, about %zu bytes and %.3g s\n", 
+            getStrategyName(plan.strategy), plan.bytes, plan.seconds);
+    }
+    struct solution *solution = solveProblemPlan(problem, &plan);
+
+    outputProblem(problem, solution, out);
+
+    freeSolution(solution, problem);
+    freeProblem(problem);
+
+    /* Flushes what was printed into output. */
+    fclose(out);
+}
+
+void *batchWorker(void *arg){
+    struct batch *b = (struct batch *) arg;
+    struct workspace *workspace = newWorkspace();
+    int pendingLimit = PENDING_JOBS_PER_THREAD * b->threadCount;
+
+    pthread_mutex_lock(&(b->lock));
+    while(b->nextJob < b->jobCount){
+        /* Don't run too far ahead of the output. */
+        if(b->nextJob >= b->nextOutput + pendingLimit){
+            pthread_cond_wait(&(b->outputWritten), &(b->lock));
+            continue;
+        }
+        struct job *job = &(b->jobs[b->nextJob]);
+        b->nextJob++;
+        pthread_mutex_unlock(&(b->lock));
+
+        char *output = NULL;
+        size_t outputLength = 0;
+        runJob(job, workspace, &output, &outputLength);
+
+        pthread_mutex_lock(&(b->lock));
+        job->outputLength = outputLength;
+        job->output = output;
+        pthread_cond_broadcast(&(b->jobFinished));
+    }
+    pthread_mutex_unlock(&(b->lock));
+
+    freeWorkspace(workspace);
+
+    return NULL;
+}
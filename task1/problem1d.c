@@ -18,16 +18,99 @@
         for use in the modified DTW, for example:
     
         ./problem1d test_cases/1d-1-seqA.txt test_cases/1d-1-seqB.txt 3
+    
+    Adding -t followed by a number of threads computes the band in 
+        parallel along anti-diagonals, e.g.
+    
+        ./problem1d test_cases/1d-1-seqA.txt test_cases/1d-1-seqB.txt 3 -t 4
+    
+    Adding -p followed by long, double or float sets the precision the 
+        DTW recurrence is computed in, e.g.
+    
+        ./problem1d test_cases/1d-1-seqA.txt test_cases/1d-1-seqB.txt 3 -p double
+    
+    Adding -e followed by a cost threshold stops as soon as the DTW 
+        distance is certain to exceed it, printing "exceeds threshold" 
+        instead of the solution, e.g.
+    
+        ./problem1d test_cases/1d-1-seqA.txt test_cases/1d-1-seqB.txt 3 -e 5
+
+    Adding -a also finds an optimal warping path (alignment) using memory 
+        linear in the sequence lengths, printing its (i,j) cells in order 
+        after the solution, e.g.
+    
+        ./problem1d test_cases/1d-1-seqA.txt test_cases/1d-1-seqB.txt 3 -a
+
+    Adding -b followed by a file name also writes the matrix to that file 
+        as a binary matrix file of long doubles (see sequenceFile.h), e.g.
+    
+        ./problem1d test_cases/1d-1-seqA.txt test_cases/1d-1-seqB.txt 3 -b matrix.bin
+
+    Sequence files with a dimensions header and a line per dimension (or 
+        binary files with more than one dimension, see sequenceFile.h) 
+        give multivariate DTW, where adding -m followed by l1 or l2 sets 
+        the distance between steps, e.g.
+    
+        ./problem1d test_cases/1d-1-seqA.txt test_cases/1d-1-seqB.txt 3 -m l2
+
+    Adding -c followed by abs or squared sets the cost of matching two 
+        values, |a - b| or (a - b)^2, and adding -s followed by 
+        symmetric1, symmetric2 or weighted sets the step pattern, where 
+        diagonal steps add the cost once, twice, or times the weight given 
+        after -w (1 by default), e.g.
+    
+        ./problem1d test_cases/1d-1-seqA.txt test_cases/1d-1-seqB.txt 3 -c squared -s weighted -w 1.5
+
+    Adding -x treats window_size as a starting guess, doubling the window 
+        until no path outside it could be cheaper, so the distance printed 
+        is the exact unconstrained (Part A) one, whether or not the 
+        sequences have the same length (checkAdaptive checks this against 
+        Part A). The window size used is printed after the solution, e.g.
+    
+        ./problem1d test_cases/1d-1-seqA.txt test_cases/1d-1-seqB.txt 1 -x
+
+    Adding -l centres the window on the line from (1, 1) to (n, m) instead 
+        of the diagonal, widening it along with the line's slope, adding 
+        -i followed by a slope of at least 1 uses the Itakura parallelogram 
+        of that slope instead (ignoring window_size), and adding -r 
+        followed by a file name uses the ranges of columns in that file, 
+        a "dimensions 2" header, a line of each row's first column and a 
+        line of each row's last column, in the sequence format, e.g.
+    
+        ./problem1d test_cases/1d-1-seqA.txt test_cases/1d-1-seqB.txt 3 -l
+        ./problem1d test_cases/1d-1-seqA.txt test_cases/1d-1-seqB.txt 0 -i 2
+        ./problem1d test_cases/1d-1-seqA.txt test_cases/1d-1-seqB.txt 0 -r ranges.txt
+
+        Only the cells these windows admit are stored and visited.
+
+    Adding -M followed by a number of bytes (with an optional K, M or G 
+        suffix) picks the fastest way of solving which fits in that much 
+        memory, reporting it on stderr, and fails if none does. Without it, 
+        the budget is the machine's physical memory. Unless -b is given, 
+        a band can be solved in two rolling rows, e.g.
+    
+        ./problem1d test_cases/1d-1-seqA.txt test_cases/1d-1-seqB.txt 3 -M 1M
 */
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <string.h>
 //#include <error.h>
 #include "problem.h"
+#include "sequenceFile.h"
 
 #define SEQ_A_ARG 1
 #define SEQ_B_ARG 2
 #define WINDOW_SIZE_ARG 3
+#define FLAGS_START_ARG 4
+
+#define MATRIX_FLAG "-b"
+#define ADAPTIVE_FLAG "-x"
+#define SLANTED_FLAG "-l"
+#define ITAKURA_FLAG "-i"
+#define RANGES_FLAG "-r"
+/* Letters of the flags parseSolveOption reads. */
+#define SOLVE_OPTIONS "tpeamcswM"
 
 #define NUMBER_BASE (10)
 
@@ -40,13 +123,63 @@ int main(int argc, char **argv){
     FILE *seqBFile = NULL;
 
     int window_size = 0;
+    /* Options shared with the other drivers. */
+    struct solveOptions options;
+    /* File to write the binary matrix to, if any. */
+    char *matrixFileName = NULL;
+    /* Whether to widen the window until the distance is exact. */
+    int adaptive = 0;
+    /* Shape of the window, the Itakura slope and the file of row ranges. */
+    enum windowShape windowShape = WINDOW_SAKOE_CHIBA;
+    long double itakuraSlope = 2;
+    char *rangesFileName = NULL;
+    /* How the problem is solved. */
+    struct solvePlan plan;
 
     if(argc < 4){
         fprintf(stderr, "You only gave %d arguments to the program, \n"
             "you should run the program with in the form \n"
-            "\t./problem1d seqA seqB window_size\n", argc);
+            "\t./problem1d seqA seqB window_size [-t threads] [-p long|double|float]\n"
+            "\t\t[-e threshold] [-a] [-b matrix_file] [-m l1|l2]\n"
+            "\t\t[-c abs|squared] [-s symmetric1|symmetric2|weighted] [-w weight]\n"
+            "\t\t[-x] [-l] [-i slope] [-r ranges_file] [-M bytes]\n", 
+            argc);
         return EXIT_FAILURE;
     } 
+
+    initSolveOptions(&options);
+    for(int arg = FLAGS_START_ARG; arg < argc; arg++){
+        int read = parseSolveOption(argc, argv, &arg, SOLVE_OPTIONS, 
+            &options);
+        if(read < 0){
+            return EXIT_FAILURE;
+        } else if(read){
+            continue;
+        }
+        if(strcmp(argv[arg], MATRIX_FLAG) == 0 && arg + 1 < argc){
+            arg++;
+            matrixFileName = argv[arg];
+        } else if(strcmp(argv[arg], ADAPTIVE_FLAG) == 0){
+            adaptive = 1;
+        } else if(strcmp(argv[arg], SLANTED_FLAG) == 0){
+            windowShape = WINDOW_SLANTED_BAND;
+        } else if(strcmp(argv[arg], ITAKURA_FLAG) == 0 && arg + 1 < argc){
+            arg++;
+            windowShape = WINDOW_ITAKURA;
+            itakuraSlope = strtold(argv[arg], NULL);
+            if(itakuraSlope < 1){
+                fprintf(stderr, "The Itakura slope must be at least 1\n");
+                return EXIT_FAILURE;
+            }
+        } else if(strcmp(argv[arg], RANGES_FLAG) == 0 && arg + 1 < argc){
+            arg++;
+            windowShape = WINDOW_ROW_RANGES;
+            rangesFileName = argv[arg];
+        } else {
+            fprintf(stderr, "Unrecognised option \"%s\"\n", argv[arg]);
+            return EXIT_FAILURE;
+        }
+    }
     
     /* Attempt to open dictionary and board files. */
     seqAFile = fopen(argv[SEQ_A_ARG], "r");
@@ -78,9 +211,84 @@ int main(int argc, char **argv){
         fclose(seqBFile);
     }
 
-    solution = solveProblemD(problem);
+    setProblemSolveOptions(problem, &options);
+    if(rangesFileName){
+        FILE *rangesFile = fopen(rangesFileName, "r");
+        if(! rangesFile){
+            fprintf(stderr, "File given as ranges file was \"%s\", "
+                "which was unable to be opened\n", rangesFileName);
+            perror("Reason for file open failure");
+            return EXIT_FAILURE;
+        }
+        int rowCount = 0;
+        int lines = 1;
+        long double *bounds = NULL;
+        struct sequenceMapping *mapping = loadMultivariateSequence(rangesFile, 
+            &rowCount, &lines, &bounds);
+        fclose(rangesFile);
+        if(lines != 2){
+            fprintf(stderr, "The ranges file should have a \"dimensions 2\" "
+                "header, a line of first columns and a line of last columns\n");
+            return EXIT_FAILURE;
+        }
+        int *lo = (int *) malloc(sizeof(int) * rowCount);
+        assert(lo);
+        int *hi = (int *) malloc(sizeof(int) * rowCount);
+        assert(hi);
+        for(int i = 0; i < rowCount; i++){
+            lo[i] = (int) bounds[i];
+            hi[i] = (int) bounds[rowCount + i];
+        }
+        setProblemRowRanges(problem, lo, hi, rowCount);
+        free(lo);
+        free(hi);
+        if(mapping){
+            freeSequenceMapping(mapping);
+        } else {
+            free(bounds);
+        }
+    } else {
+        setProblemWindowShape(problem, windowShape, itakuraSlope);
+    }
+
+    if(adaptive){
+        solution = solveProblemDAdaptive(problem);
+    } else {
+        /* Only the matrix file needs the band's cells kept. */
+        if(! chooseProblemPlan(problem, ! matrixFileName, 
+            options.memoryBudget, &plan)){
+            fprintf(stderr, "Solving needs at least %zu bytes with %s, "
+                "more than the memory budget\n", plan.bytes, 
+                getStrategyName(plan.strategy));
+            freeProblem(problem);
+            return EXIT_FAILURE;
+        }
+        if(options.memoryBudget){
+            fprintf(stderr, "Solving with %s, about %zu bytes and %.3g s\n", 
+                getStrategyName(plan.strategy), plan.bytes, plan.seconds);
+        }
+        solution = solveProblemPlan(problem, &plan);
+    }
 
     outputProblem(problem, solution, stdout);
+    if(adaptive){
+        printf("window size: %d\n", getSolutionWindowSize(solution));
+    }
+
+    if(matrixFileName){
+        FILE *matrixFile = fopen(matrixFileName, "wb");
+        if(! matrixFile){
+            fprintf(stderr, "File given as matrix file was \"%s\", "
+                "which was unable to be opened\n", matrixFileName);
+            perror("Reason for file open failure");
+        } else {
+            if(! outputProblemMatrix(problem, solution, matrixFile)){
+                fprintf(stderr, "No matrix to write to \"%s\"\n", 
+                    matrixFileName);
+            }
+            fclose(matrixFile);
+        }
+    }
 
     freeSolution(solution, problem);
 
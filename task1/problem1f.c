@@ -19,16 +19,54 @@
         example:
     
         ./problem1f test_cases/1f-1-seqA.txt test_cases/1f-1-seqB.txt 11
+    
+    Adding -t followed by a number of threads shares the rows of each 
+        layer out among that many threads, e.g.
+    
+        ./problem1f test_cases/1f-1-seqA.txt test_cases/1f-1-seqB.txt 11 -t 4
+    
+    Adding -p followed by long, double or float sets the precision the 
+        layers are computed in, double and float rows being computed with 
+        vector instructions, e.g.
+    
+        ./problem1f test_cases/1f-1-seqA.txt test_cases/1f-1-seqB.txt 11 -p double
+
+    Sequence files with a dimensions header and a line per dimension (or 
+        binary files with more than one dimension, see sequenceFile.h) 
+        give multivariate DTW, where adding -m followed by l1 or l2 sets 
+        the distance between steps, e.g.
+    
+        ./problem1f test_cases/1f-1-seqA.txt test_cases/1f-1-seqB.txt 11 -m l2
+
+    Adding -c followed by abs or squared sets the cost of matching two 
+        values, |a - b| or (a - b)^2, and adding -s followed by 
+        symmetric1, symmetric2 or weighted sets the step pattern, where 
+        diagonal steps add the cost once, twice, or times the weight given 
+        after -w (1 by default), e.g.
+    
+        ./problem1f test_cases/1f-1-seqA.txt test_cases/1f-1-seqB.txt 11 -c squared -s weighted -w 1.5
+
+    Adding -M followed by a number of bytes (with an optional K, M or G 
+        suffix) reports the memory and rough time solving needs on stderr, 
+        failing if that is more than the budget given. Without it, the 
+        budget is the machine's physical memory, e.g.
+    
+        ./problem1f test_cases/1f-1-seqA.txt test_cases/1f-1-seqB.txt 11 -M 16K
 */
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <string.h>
 //#include <error.h>
 #include "problem.h"
 
 #define SEQ_A_ARG 1
 #define SEQ_B_ARG 2
 #define MAX_PATH_LENGTH_ARG 3
+#define FLAGS_START_ARG 4
+
+/* Letters of the flags parseSolveOption reads. */
+#define SOLVE_OPTIONS "tpmcswM"
 
 #define NUMBER_BASE (10)
 
@@ -41,13 +79,32 @@ int main(int argc, char **argv){
     FILE *seqBFile = NULL;
 
     int max_path_length = 0;
+    /* Options shared with the other drivers. */
+    struct solveOptions options;
+    /* How the problem is solved. */
+    struct solvePlan plan;
 
     if(argc < 4){
         fprintf(stderr, "You only gave %d arguments to the program, \n"
             "you should run the program with in the form \n"
-            "\t./problem1f seqA seqB max_path_length\n", argc);
+            "\t./problem1f seqA seqB max_path_length [-t threads]\n"
+            "\t\t[-p long|double|float] [-m l1|l2] [-c abs|squared]\n"
+            "\t\t[-s symmetric1|symmetric2|weighted] [-w weight]\n"
+            "\t\t[-M bytes]\n", argc);
         return EXIT_FAILURE;
     } 
+
+    initSolveOptions(&options);
+    for(int arg = FLAGS_START_ARG; arg < argc; arg++){
+        int read = parseSolveOption(argc, argv, &arg, SOLVE_OPTIONS, 
+            &options);
+        if(read < 0){
+            return EXIT_FAILURE;
+        } else if(! read){
+            fprintf(stderr, "Unrecognised option \"%s\"\n", argv[arg]);
+            return EXIT_FAILURE;
+        }
+    }
     
     /* Attempt to open dictionary and board files. */
     seqAFile = fopen(argv[SEQ_A_ARG], "r");
@@ -79,7 +136,20 @@ int main(int argc, char **argv){
         fclose(seqBFile);
     }
 
-    solution = solveProblemF(problem);
+    setProblemSolveOptions(problem, &options);
+
+    if(! chooseProblemPlan(problem, 1, options.memoryBudget, &plan)){
+        fprintf(stderr, "Solving needs at least %zu bytes with %s, "
+            "more than the memory budget\n", plan.bytes, 
+            getStrategyName(plan.strategy));
+        freeProblem(problem);
+        return EXIT_FAILURE;
+    }
+    if(options.memoryBudget){
+        fprintf(stderr, "Solving with %s, about %zu bytes and %.3g s\n", 
+            getStrategyName(plan.strategy), plan.bytes, plan.seconds);
+    }
+    solution = solveProblemPlan(problem, &plan);
 
     outputProblem(problem, solution, stdout);
 
@@ -0,0 +1,175 @@
+/*
+    Make using
+        make problem1search
+
+    Run using
+        ./problem1search query candidates window_size [k]
+
+    where query is the name of the file with the query sequence in the
+        expected format (e.g. test_cases/1d-1-seqA.txt), candidates is
+        either a directory of candidate sequence files or a manifest file
+        listing one candidate file per line (lines starting with # are
+        skipped), window_size is the window size for the windowed DTW
+        as in Part D, and k is how many of the nearest candidates to
+        report (1 by default), for example:
+
+        ./problem1search test_cases/1d-1-seqA.txt test_cases 3 5
+
+    The query is read once, and each candidate is read once and only
+        compared with full DTW if cheaper lower bounds can't rule it out.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "problem.h"
+#include "search.h"
+
+#define QUERY_ARG 1
+#define CANDIDATES_ARG 2
+#define WINDOW_SIZE_ARG 3
+#define K_ARG 4
+#define NUMBER_BASE (10)
+
+#define MANIFEST_COMMENT '#'
+
+/* Reads the candidate in the given file and searches it. */
+void searchFile(struct searchQuery *q, char *fileName);
+
+/* Searches every regular file in the given directory, in name order. */
+void searchDirectory(struct searchQuery *q, char *directoryName);
+
+/* Searches every file listed in the given manifest. */
+void searchManifest(struct searchQuery *q, FILE *manifest);
+
+int main(int argc, char **argv){
+    int window_size = 0;
+    int k = 1;
+
+    if(argc < 4){
+        fprintf(stderr, "You only gave %d arguments to the program, \n"
+            "you should run the program with in the form \n"
+            "\t./problem1search query candidates window_size [k]\n", argc);
+        return EXIT_FAILURE;
+    }
+
+    FILE *queryFile = fopen(argv[QUERY_ARG], "r");
+    if(! queryFile){
+        fprintf(stderr, "File given as query file was \"%s\", "
+            "which was unable to be opened\n", argv[QUERY_ARG]);
+        perror("Reason for file open failure");
+        return EXIT_FAILURE;
+    }
+    window_size = strtol(argv[WINDOW_SIZE_ARG], NULL, NUMBER_BASE);
+    if(argc > K_ARG){
+        k = strtol(argv[K_ARG], NULL, NUMBER_BASE);
+        if(k < 1){
+            fprintf(stderr, "k must be at least 1\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    int queryLength = 0;
+    long double *query = NULL;
+    readSequence(queryFile, &queryLength, &query);
+    fclose(queryFile);
+
+    struct searchQuery *q = newSearchQuery(query, queryLength, window_size, k);
+
+    struct stat candidatesStat;
+    if(stat(argv[CANDIDATES_ARG], &candidatesStat) != 0){
+        fprintf(stderr, "Candidates given as \"%s\", which was unable to "
+            "be found\n", argv[CANDIDATES_ARG]);
+        perror("Reason for failure");
+        return EXIT_FAILURE;
+    }
+    if(S_ISDIR(candidatesStat.st_mode)){
+        searchDirectory(q, argv[CANDIDATES_ARG]);
+    } else {
+        FILE *manifest = fopen(argv[CANDIDATES_ARG], "r");
+        if(! manifest){
+            fprintf(stderr, "File given as manifest file was \"%s\", "
+                "which was unable to be opened\n", argv[CANDIDATES_ARG]);
+            perror("Reason for file open failure");
+            return EXIT_FAILURE;
+        }
+        searchManifest(q, manifest);
+        fclose(manifest);
+    }
+
+    struct searchMatch *matches;
+    int matchCount = getSearchMatches(q, &matches);
+    for(int i = 0; i < matchCount; i++){
+        printf("%d %.2Lf %s\n", i + 1, matches[i].distance, matches[i].name);
+    }
+
+    struct searchStats stats = getSearchStats(q);
+    printf("candidates: %d, pruned by LB_Kim: %d, pruned by LB_Keogh: %d, "
+        "abandoned: %d, full DTW: %d\n", stats.candidates, stats.prunedKim,
+        stats.prunedKeogh, stats.abandoned, stats.computed);
+
+    freeSearchQuery(q);
+    free(query);
+
+    return EXIT_SUCCESS;
+}
+
+void searchFile(struct searchQuery *q, char *fileName){
+    FILE *candidateFile = fopen(fileName, "r");
+    if(! candidateFile){
+        fprintf(stderr, "Skipping candidate \"%s\", which was unable to be "
+            "opened\n", fileName);
+        return;
+    }
+    int candidateLength = 0;
+    long double *candidate = NULL;
+    readSequence(candidateFile, &candidateLength, &candidate);
+    fclose(candidateFile);
+
+    searchCandidate(q, fileName, candidate, candidateLength);
+
+    free(candidate);
+}
+
+void searchDirectory(struct searchQuery *q, char *directoryName){
+    struct dirent **entries;
+    int entryCount = scandir(directoryName, &entries, NULL, alphasort);
+    if(entryCount < 0){
+        perror("Encountered error reading candidate directory");
+        exit(EXIT_FAILURE);
+    }
+    for(int i = 0; i < entryCount; i++){
+        char *path = (char *) malloc(strlen(directoryName) +
+            strlen(entries[i]->d_name) + 2);
+        assert(path);
+        sprintf(path, "%s/%s", directoryName, entries[i]->d_name);
+        struct stat entryStat;
+        if(entries[i]->d_name[0] != '.' && stat(path, &entryStat) == 0 &&
+            S_ISREG(entryStat.st_mode)){
+            searchFile(q, path);
+        }
+        free(path);
+        free(entries[i]);
+    }
+    free(entries);
+}
+
+void searchManifest(struct searchQuery *q, FILE *manifest){
+    char *line = NULL;
+    size_t allocated = 0;
+    ssize_t lineLength;
+    while((lineLength = getline(&line, &allocated, manifest)) != -1){
+        /* Trim the newline and any trailing whitespace. */
+        while(lineLength > 0 && (line[lineLength - 1] == '\n' ||
+            line[lineLength - 1] == '\r' || line[lineLength - 1] == ' ')){
+            line[--lineLength] = '\0';
+        }
+        if(lineLength == 0 || line[0] == MANIFEST_COMMENT){
+            continue;
+        }
+        searchFile(q, line);
+    }
+    free(line);
+}
@@ -0,0 +1,128 @@
+/*
+    Make using
+        make problem1subsequence
+
+    Run using
+        ./problem1subsequence pattern stream threshold [-f] [-c abs|squared]
+
+    where pattern is the name of the file with the short sequence to look
+        for in the expected format (e.g. test_cases/1a-1-seqA.txt), stream
+        is the name of the file with the sequence to look in, or - for
+        stdin, and threshold is the largest DTW distance a match may have,
+        for example:
+
+        ./problem1subsequence test_cases/1a-1-seqA.txt test_cases/1a-1-seqB.txt 2
+
+    Matches may start and end anywhere in the stream. Each is printed as
+        its start and end positions in the stream (counting its first value
+        as 1) and its DTW distance, as soon as no cheaper overlapping match
+        is possible. The stream is read a batch of values at a time, and
+        never held whole, so it may be as long as needed.
+
+    Adding -f follows the stream file as it grows, like tail -f, until
+        interrupted, and adding -c followed by abs or squared sets the cost
+        of matching two values, e.g.
+
+        tail -f live.txt | ./problem1subsequence test_cases/1a-1-seqA.txt - 2
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include "problem.h"
+#include "sequenceStream.h"
+#include "subsequence.h"
+
+#define PATTERN_ARG 1
+#define STREAM_ARG 2
+#define THRESHOLD_ARG 3
+#define FLAGS_START_ARG 4
+
+#define FOLLOW_FLAG "-f"
+#define COST_FLAG "-c"
+
+/* Prints the given matches. */
+void printMatches(struct subsequenceMatch *matches, int matchCount);
+
+int main(int argc, char **argv){
+    /* Whether to follow the stream file as it grows. */
+    int follow = 0;
+    /* Cost of matching two values. */
+    enum dtwCost cost = COST_ABSOLUTE;
+
+    if(argc < 4){
+        fprintf(stderr, "You only gave %d arguments to the program, \n"
+            "you should run the program with in the form \n"
+            "\t./problem1subsequence pattern stream threshold [-f] "
+            "[-c abs|squared]\n", argc);
+        return EXIT_FAILURE;
+    }
+
+    for(int arg = FLAGS_START_ARG; arg < argc; arg++){
+        if(strcmp(argv[arg], FOLLOW_FLAG) == 0){
+            follow = 1;
+        } else if(strcmp(argv[arg], COST_FLAG) == 0 && arg + 1 < argc){
+            arg++;
+            if(strcmp(argv[arg], "abs") == 0){
+                cost = COST_ABSOLUTE;
+            } else if(strcmp(argv[arg], "squared") == 0){
+                cost = COST_SQUARED;
+            } else {
+                fprintf(stderr, "Unrecognised cost \"%s\"\n", argv[arg]);
+                return EXIT_FAILURE;
+            }
+        } else {
+            fprintf(stderr, "Unrecognised option \"%s\"\n", argv[arg]);
+            return EXIT_FAILURE;
+        }
+    }
+    long double threshold = strtold(argv[THRESHOLD_ARG], NULL);
+
+    FILE *patternFile = fopen(argv[PATTERN_ARG], "r");
+    if(! patternFile){
+        fprintf(stderr, "File given as pattern file was \"%s\", "
+            "which was unable to be opened\n", argv[PATTERN_ARG]);
+        perror("Reason for file open failure");
+        return EXIT_FAILURE;
+    }
+    int patternLength = 0;
+    long double *pattern = NULL;
+    readSequence(patternFile, &patternLength, &pattern);
+    fclose(patternFile);
+
+    struct sequenceStream *stream = openSequenceStream(argv[STREAM_ARG], 
+        follow);
+    if(! stream){
+        fprintf(stderr, "File given as stream file was \"%s\", "
+            "which was unable to be opened\n", argv[STREAM_ARG]);
+        perror("Reason for file open failure");
+        return EXIT_FAILURE;
+    }
+
+    struct subsequenceSearch *s = newSubsequenceSearch(pattern, 
+        patternLength, cost, threshold);
+    struct subsequenceMatch *matches;
+    long double *values;
+    int count;
+    while((count = readSequenceStream(stream, &values)) > 0){
+        int matchCount = appendSubsequenceSearch(s, values, count, &matches);
+        free(values);
+        printMatches(matches, matchCount);
+    }
+    printMatches(matches, finishSubsequenceSearch(s, &matches));
+
+    closeSequenceStream(stream);
+    freeSubsequenceSearch(s);
+    free(pattern);
+
+    return EXIT_SUCCESS;
+}
+
+void printMatches(struct subsequenceMatch *matches, int matchCount){
+    for(int i = 0; i < matchCount; i++){
+        printf("%lld %lld %.2Lf\n", matches[i].start, matches[i].end, 
+            matches[i].distance);
+    }
+    /* Matches are wanted as they are found, even through a pipe. */
+    fflush(stdout);
+}
@@ -27,12 +27,62 @@ struct problem {
     /* The numbers in sequence B. */
     long double *sequenceB;
 
+    /* Values per step of both sequences. Multivariate sequences hold one 
+        run of values per dimension, e.g. value d of step i of sequence A 
+        is sequenceA[d * seqALength + i]. */
+    int dimensions;
+    /* For multivariate sequences, how the distance between steps is 
+        measured. */
+    enum stepMetric metric;
+    /* For multivariate sequences, double precision copies of the 
+        sequences for the step distance kernels, made on first use. */
+    double *stepsA;
+    double *stepsB;
+
+    /* The recurrence solved, see setProblemCost and setProblemStepPattern. */
+    enum dtwCost cost;
+    enum stepPattern step;
+    long double diagonalWeight;
+
+    /* 1 if the sequences are freed along with the problem. */
+    int ownsSequences;
+
+    /* If set, the binary sequence file each sequence points into. */
+    struct sequenceMapping *mappingA;
+    struct sequenceMapping *mappingB;
+
     /* For Part D only, the window size. */
     int windowSize;
 
+    /* For Part D only, the shape of the window, the Itakura 
+        parallelogram's slope, and for WINDOW_ROW_RANGES, the first and 
+        last columns of each row, rangeLo[i - 1] to rangeHi[i - 1] for row i. */
+    enum windowShape windowShape;
+    long double itakuraSlope;
+    int *rangeLo;
+    int *rangeHi;
+
     /* For Part F only, the maximum path length. */
     int maximumPathLength;
 
+    /* For Part A and D, the number of threads to solve with. */
+    int threadCount;
+
+    /* For Part A and D, the precision to solve in. */
+    enum dtwPrecision precision;
+
+    /* For Part A and D, the cost above which solving may stop early. */
+    long double threshold;
+
+    /* If set, where the solvers take their memory from. */
+    struct workspace *workspace;
+
+    /* For Part A and D, 1 if the warping path should be found. */
+    int findPath;
+
+    /* For Part A, how the matrix is laid out in memory. */
+    enum matrixLayout layout;
+
     /* Which problem part is being solved. */
     enum problemPart part;
 };
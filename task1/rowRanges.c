@@ -0,0 +1,88 @@
+/*
+    Implementation for module which works out the columns a Part D window
+        shape admits in each row of the matrix.
+
+    Bounds on a line are rounded inwards, with a little slack so values
+        which are whole numbers in exact arithmetic are not lost to
+        rounding error.
+*/
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include "rowRanges.h"
+
+/* Slack allowed when rounding a bound to a column. */
+#define ROUNDING_SLACK 1e-9L
+
+/* Sets row 0, which only admits the start cell (0, 0). */
+static void startRow(int *lo, int *hi);
+
+/* Sets row i to the columns from first to last, clipped to 1 to m. */
+static void setRange(int i, int m, long double first, long double last,
+    int *lo, int *hi);
+
+static void startRow(int *lo, int *hi){
+    lo[0] = 0;
+    hi[0] = 0;
+}
+
+static void setRange(int i, int m, long double first, long double last,
+    int *lo, int *hi){
+    long double roundedFirst = ceill(first - ROUNDING_SLACK);
+    long double roundedLast = floorl(last + ROUNDING_SLACK);
+    if(roundedFirst < 1){
+        lo[i] = 1;
+    } else {
+        lo[i] = (roundedFirst > m + 1) ? m + 1 : (int) roundedFirst;
+    }
+    /* Empty rows have hi[i] = lo[i] - 1, so they hold no cells. */
+    if(roundedLast > m){
+        hi[i] = m;
+    } else {
+        hi[i] = (roundedLast < lo[i] - 1) ? lo[i] - 1 : (int) roundedLast;
+    }
+}
+
+void slantedBandRanges(int n, int m, int windowSize, int *lo, int *hi){
+    startRow(lo, hi);
+    /* Columns the line moves along per row. */
+    long double slope = (n > 1) ? (long double) (m - 1) / (n - 1) : 0;
+    long double radius = (slope > 1) ? windowSize * slope : windowSize;
+    for(int i = 1; i <= n; i++){
+        if(windowSize < 0){
+            setRange(i, m, 1, 0, lo, hi);
+        } else if(n == 1){
+            /* Every path runs along the only row. */
+            setRange(i, m, 1, m, lo, hi);
+        } else {
+            long double centre = 1 + (i - 1) * slope;
+            setRange(i, m, centre - radius, centre + radius, lo, hi);
+        }
+    }
+}
+
+void itakuraRanges(int n, int m, long double slope, int *lo, int *hi){
+    assert(slope >= 1);
+    startRow(lo, hi);
+    for(int i = 1; i <= n; i++){
+        /* Reachable from (1, 1), and able to reach (n, m). */
+        long double first = fmaxl(1 + (i - 1) / slope, m - (n - i) * slope);
+        long double last = fminl(1 + (i - 1) * slope, m - (n - i) / slope);
+        setRange(i, m, first, last, lo, hi);
+    }
+}
+
+void givenRanges(int n, int m, int *rowLo, int *rowHi, int *lo, int *hi){
+    startRow(lo, hi);
+    for(int i = 1; i <= n; i++){
+        setRange(i, m, rowLo[i - 1], rowHi[i - 1], lo, hi);
+    }
+}
+
+size_t rowRangeOffsets(int n, int *lo, int *hi, size_t *offset){
+    offset[0] = 0;
+    for(int i = 0; i <= n; i++){
+        offset[i + 1] = offset[i] + (size_t) (hi[i] - lo[i] + 1);
+    }
+    return offset[n + 1];
+}
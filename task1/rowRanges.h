@@ -0,0 +1,44 @@
+/*
+    Header for module which works out the columns a Part D window shape
+        admits in each row of the matrix, so the solvers can store and
+        visit only those cells rather than all n * m of them.
+
+    Every function fills in lo[i] and hi[i], the first and last admissible
+        columns of row i, for rows 0 to n. Row 0 only admits column 0, and
+        a row admitting no columns has lo[i] = hi[i] + 1.
+*/
+
+#ifndef ROWRANGES_H
+#define ROWRANGES_H
+
+#include <stddef.h>
+
+/*
+    Admits the cells within windowSize columns of the straight line from 
+    (1, 1) to (n, m), or windowSize times the columns it moves per row if 
+    that is more than one. A windowSize of at least 1 always admits a path.
+*/
+void slantedBandRanges(int n, int m, int windowSize, int *lo, int *hi);
+
+/*
+    Admits the Itakura parallelogram, the cells reachable from (1, 1) and
+    reaching (n, m) along lines with slopes between 1 / slope and slope,
+    which must be at least 1. No cell is admitted if the lengths differ by
+    more than a factor of slope.
+*/
+void itakuraRanges(int n, int m, long double slope, int *lo, int *hi);
+
+/*
+    Admits columns rowLo[i - 1] to rowHi[i - 1] of each row i from 1 to n,
+    clipped to columns 1 to m.
+*/
+void givenRanges(int n, int m, int *rowLo, int *rowHi, int *lo, int *hi);
+
+/*
+    Sets offset[i] to the number of admissible cells before row i, for rows
+    0 to n + 1, so cell (i, j) of a block of them is at offset[i] + j - lo[i].
+    Returns the total number of admissible cells, offset[n + 1].
+*/
+size_t rowRangeOffsets(int n, int *lo, int *hi, size_t *offset);
+
+#endif
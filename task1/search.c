@@ -0,0 +1,256 @@
+/*
+    Implementation for module which finds the candidate sequences nearest
+        to a query sequence under windowed (Part D) DTW.
+
+    Both lower bounds rely on every value of both sequences being matched
+        at least once by the warping path:
+        - LB_Kim: the path always matches the first values together and
+          the last values together.
+        - LB_Keogh: with a window of w, candidate value j can only be
+          matched to query values j - w to j + w, so it costs at least its
+          distance to the [lower, upper] envelope of those query values.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <math.h>
+#include "problem.h"
+#include "search.h"
+
+struct searchQuery {
+    /* The query sequence. */
+    long double *query;
+    int length;
+    int windowSize;
+    /* lower[j - 1] and upper[j - 1] are the smallest and largest query
+        values candidate value j can be matched with. Computed for
+        candidates up to envelopeLength long, extended as needed. */
+    long double *lower;
+    long double *upper;
+    int envelopeLength;
+    /* The best matches so far, nearest first. */
+    int k;
+    int matchCount;
+    struct searchMatch *matches;
+    struct searchStats stats;
+};
+
+/* Makes sure the envelope covers candidates of the given length. */
+static void ensureEnvelope(struct searchQuery *q, int length);
+
+/* Distance from the given value to the interval [lower, upper]. */
+static long double envelopeDistance(long double value, long double lower,
+    long double upper);
+
+/* The distance a candidate must beat to become one of the k best. */
+static long double kthBestDistance(struct searchQuery *q);
+
+struct searchQuery *newSearchQuery(long double *query, int length,
+    int windowSize, int k){
+    struct searchQuery *q = (struct searchQuery *)
+        malloc(sizeof(struct searchQuery));
+    assert(q);
+    assert(length > 0 && k > 0);
+
+    q->query = query;
+    q->length = length;
+    q->windowSize = windowSize;
+    q->lower = NULL;
+    q->upper = NULL;
+    q->envelopeLength = 0;
+
+    q->k = k;
+    q->matchCount = 0;
+    q->matches = (struct searchMatch *) malloc(sizeof(struct searchMatch) * k);
+    assert(q->matches);
+
+    q->stats.candidates = 0;
+    q->stats.prunedKim = 0;
+    q->stats.prunedKeogh = 0;
+    q->stats.abandoned = 0;
+    q->stats.computed = 0;
+
+    /* Most candidates will be about as long as the query. */
+    ensureEnvelope(q, length);
+
+    return q;
+}
+
+static void ensureEnvelope(struct searchQuery *q, int length){
+    if(length <= q->envelopeLength){
+        return;
+    }
+    q->lower = (long double *) realloc(q->lower, sizeof(long double) * length);
+    assert(q->lower);
+    q->upper = (long double *) realloc(q->upper, sizeof(long double) * length);
+    assert(q->upper);
+
+    /* Sliding window minimum and maximum over query values
+        max(1, j - w) to min(n, j + w), both of which only move forward,
+        so each deque holds indices whose values are monotonic. */
+    int *minDeque = (int *) malloc(sizeof(int) * q->length);
+    assert(minDeque);
+    int *maxDeque = (int *) malloc(sizeof(int) * q->length);
+    assert(maxDeque);
+    int minHead = 0, minTail = 0, maxHead = 0, maxTail = 0;
+    /* Next query index (1-based) to add to the window. */
+    int next = 1;
+    for(int j = 1; j <= length; j++){
+        long long windowStart = (long long) j - q->windowSize;
+        long long windowEnd = (long long) j + q->windowSize;
+        if(windowStart < 1){
+            windowStart = 1;
+        }
+        if(windowEnd > q->length){
+            windowEnd = q->length;
+        }
+        while(next <= windowEnd){
+            long double value = q->query[next - 1];
+            while(minTail > minHead && q->query[minDeque[minTail - 1] - 1] >= value){
+                minTail--;
+            }
+            minDeque[minTail++] = next;
+            while(maxTail > maxHead && q->query[maxDeque[maxTail - 1] - 1] <= value){
+                maxTail--;
+            }
+            maxDeque[maxTail++] = next;
+            next++;
+        }
+        while(minHead < minTail && minDeque[minHead] < windowStart){
+            minHead++;
+        }
+        while(maxHead < maxTail && maxDeque[maxHead] < windowStart){
+            maxHead++;
+        }
+        if(windowStart > windowEnd || minHead == minTail){
+            /* No query value is in reach, an empty envelope. */
+            q->lower[j - 1] = LDINFINITY;
+            q->upper[j - 1] = -LDINFINITY;
+        } else {
+            q->lower[j - 1] = q->query[minDeque[minHead] - 1];
+            q->upper[j - 1] = q->query[maxDeque[maxHead] - 1];
+        }
+    }
+    free(minDeque);
+    free(maxDeque);
+    q->envelopeLength = length;
+}
+
+static long double envelopeDistance(long double value, long double lower,
+    long double upper){
+    if(lower > upper){
+        return LDINFINITY;
+    }
+    if(value > upper){
+        return value - upper;
+    }
+    if(value < lower){
+        return lower - value;
+    }
+    return 0;
+}
+
+static long double kthBestDistance(struct searchQuery *q){
+    if(q->matchCount < q->k){
+        return LDINFINITY;
+    }
+    return q->matches[q->matchCount - 1].distance;
+}
+
+long double lowerBoundKim(struct searchQuery *q, long double *candidate,
+    int length){
+    int n = q->length;
+    if(q->windowSize < 0 || (long long) n - length > q->windowSize ||
+        (long long) length - n > q->windowSize){
+        /* The end cell is outside the window, so DTW is infinite. */
+        return LDINFINITY;
+    }
+    long double bound = fabsl(q->query[0] - candidate[0]);
+    if(n > 1 || length > 1){
+        /* The first and last cells of the path are different cells. */
+        bound += fabsl(q->query[n - 1] - candidate[length - 1]);
+    }
+    return bound;
+}
+
+long double lowerBoundKeogh(struct searchQuery *q, long double *candidate,
+    int length, long double cutoff){
+    ensureEnvelope(q, length);
+    long double bound = 0;
+    for(int j = 0; j < length && bound <= cutoff; j++){
+        bound += envelopeDistance(candidate[j], q->lower[j], q->upper[j]);
+    }
+    return bound;
+}
+
+void searchCandidate(struct searchQuery *q, char *name,
+    long double *candidate, int length){
+    q->stats.candidates++;
+    long double best = kthBestDistance(q);
+
+    /* Cheapest bound first, a candidate must strictly beat the k-th best. */
+    if(lowerBoundKim(q, candidate, length) >= best){
+        q->stats.prunedKim++;
+        return;
+    }
+    if(lowerBoundKeogh(q, candidate, length, best) >= best){
+        q->stats.prunedKeogh++;
+        return;
+    }
+
+    struct problem *p = newProblemD(q->query, q->length, candidate, length,
+        q->windowSize);
+    setProblemThreshold(p, best);
+    struct solution *s = solveProblemD(p);
+    long double distance = getOptimalValue(s);
+    int exceeded = solutionExceedsThreshold(s);
+    freeSolution(s, p);
+    freeProblem(p);
+
+    if(exceeded){
+        q->stats.abandoned++;
+        return;
+    }
+    q->stats.computed++;
+    if(distance >= best){
+        return;
+    }
+
+    /* Insert in order, dropping the old k-th best if full. */
+    int position = (q->matchCount < q->k) ? q->matchCount : (q->k - 1);
+    if(q->matchCount == q->k){
+        free(q->matches[position].name);
+    } else {
+        q->matchCount++;
+    }
+    while(position > 0 && q->matches[position - 1].distance > distance){
+        q->matches[position] = q->matches[position - 1];
+        position--;
+    }
+    q->matches[position].name = (char *) malloc(strlen(name) + 1);
+    assert(q->matches[position].name);
+    strcpy(q->matches[position].name, name);
+    q->matches[position].distance = distance;
+}
+
+int getSearchMatches(struct searchQuery *q, struct searchMatch **matches){
+    *matches = q->matches;
+    return q->matchCount;
+}
+
+struct searchStats getSearchStats(struct searchQuery *q){
+    return q->stats;
+}
+
+void freeSearchQuery(struct searchQuery *q){
+    if(q){
+        for(int i = 0; i < q->matchCount; i++){
+            free(q->matches[i].name);
+        }
+        free(q->matches);
+        free(q->lower);
+        free(q->upper);
+        free(q);
+    }
+}
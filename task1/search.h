@@ -0,0 +1,77 @@
+/*
+    Header for module which finds the candidate sequences nearest to a
+        query sequence under windowed (Part D) DTW.
+
+    Candidates are checked against a cascade of lower bounds that are
+        cheap to compute, and only those which might beat the current k-th
+        best match go on to a full DTW, which is itself abandoned as soon
+        as it can no longer beat the k-th best match.
+*/
+
+#ifndef SEARCH_H
+#define SEARCH_H
+
+/* One of the best matches found so far. */
+struct searchMatch {
+    /* Name the candidate was given, e.g. its file name. */
+    char *name;
+    /* DTW distance between the query and the candidate. */
+    long double distance;
+};
+
+/* How many candidates were ruled out at each stage of the cascade. */
+struct searchStats {
+    /* Number of candidates searched. */
+    int candidates;
+    /* Ruled out by the first and last values (LB_Kim). */
+    int prunedKim;
+    /* Ruled out by the query's window envelope (LB_Keogh). */
+    int prunedKeogh;
+    /* Full DTW started but abandoned part way through. */
+    int abandoned;
+    /* Full DTW run to completion. */
+    int computed;
+};
+
+struct searchQuery;
+
+/*
+    Sets up a search for the k nearest candidates to the given query under
+    DTW with the given window size. The query is not copied, and must
+    outlive the search.
+*/
+struct searchQuery *newSearchQuery(long double *query, int length,
+    int windowSize, int k);
+
+/*
+    Compares the given candidate against the query, keeping it if it is one
+    of the k nearest so far. The candidate itself is not kept, only a copy
+    of its name.
+*/
+void searchCandidate(struct searchQuery *q, char *name,
+    long double *candidate, int length);
+
+/* LB_Kim lower bound on the DTW distance from the query to the candidate. */
+long double lowerBoundKim(struct searchQuery *q, long double *candidate,
+    int length);
+
+/*
+    LB_Keogh lower bound on the DTW distance from the query to the candidate,
+    using the query's envelope. Stops summing once it exceeds cutoff.
+*/
+long double lowerBoundKeogh(struct searchQuery *q, long double *candidate,
+    int length, long double cutoff);
+
+/*
+    Sets matches to the best matches found, nearest first, and returns how
+    many there are (at most k).
+*/
+int getSearchMatches(struct searchQuery *q, struct searchMatch **matches);
+
+/* Returns the pruning statistics for the search so far. */
+struct searchStats getSearchStats(struct searchQuery *q);
+
+/* Frees the search and all memory allocated for it. */
+void freeSearchQuery(struct searchQuery *q);
+
+#endif
@@ -0,0 +1,381 @@
+/*
+    Implementation for module which reads and writes sequence files.
+
+    Text files are parsed with the sequenceParser module, a line at a 
+        time if there is more than one. Binary files of floats or doubles 
+        are widened to long double as they are read, while binary files of 
+        long doubles are used as they are in the mapped file, so reading 
+        them costs nothing per value.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <limits.h>
+#include <ctype.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "sequenceFile.h"
+#include "sequenceParser.h"
+
+/* Bytes to read at a time from files which can't be mapped. */
+#define READ_CHUNK_SIZE 65536
+
+/* Significant digits needed to tell apart all values of each type. */
+#define FLOAT_DIGITS 9
+#define DOUBLE_DIGITS 17
+#define LONG_DOUBLE_DIGITS 21
+
+#define TEXT_SEPARATOR ", "
+
+/* Starts the first line of a multivariate text file, followed by the 
+    number of dimensions. */
+#define TEXT_DIMENSIONS_HEADER "dimensions"
+
+struct sequenceMapping {
+    void *address;
+    size_t length;
+};
+
+/* Returns whether the given data starts like a binary sequence file. */
+static int isBinarySequence(const char *data, size_t length);
+
+/*
+    Reads the values from the given binary sequence file data. Returns 1 if
+    seq was pointed into data (only if inPlace is 1 and the values are long
+    doubles), or 0 if seq was set to a newly allocated array.
+*/
+static int decodeBinarySequence(const char *data, size_t length,
+    int inPlace, int *seqLen, int *dimensions, long double **seq);
+
+/*
+    Parses text sequence file data. If it starts with a dimensions header,
+    each line after it which isn't blank is one dimension; otherwise all of
+    it is one dimension, newlines being whitespace like any other. Sets seq
+    to a newly allocated array of the values and seqLen to the number of
+    steps, and returns the number of dimensions.
+*/
+
+/*
+    If the given text data starts with a dimensions header line, returns
+    the dimensions it gives and sets bodyStart to the offset just past it.
+    Returns 0 if there is no header.
+*/
+static int parseDimensionsHeader(const char *data, size_t length,
+    size_t *bodyStart);
+static int parseMultivariateText(const char *data, size_t length,
+    int *seqLen, long double **seq);
+
+/* Reads the whole of the given file, setting length to its size. */
+static char *readWholeFile(FILE *seqFile, size_t *length);
+
+/* Returns the size of each value of the given element type, 0 if unknown. */
+static size_t elementTypeSize(enum sequenceElementType elementType);
+
+static int isBinarySequence(const char *data, size_t length){
+    return length >= SEQUENCE_FILE_MAGIC_SIZE &&
+        memcmp(data, SEQUENCE_FILE_MAGIC, SEQUENCE_FILE_MAGIC_SIZE) == 0;
+}
+
+static size_t elementTypeSize(enum sequenceElementType elementType){
+    switch(elementType){
+        case SEQUENCE_FLOAT:
+            return sizeof(float);
+        case SEQUENCE_DOUBLE:
+            return sizeof(double);
+        case SEQUENCE_LONG_DOUBLE:
+            return sizeof(long double);
+        default:
+            return 0;
+    }
+}
+
+static int decodeBinarySequence(const char *data, size_t length,
+    int inPlace, int *seqLen, int *dimensions, long double **seq){
+    struct sequenceFileHeader header;
+    if(length < sizeof(struct sequenceFileHeader)){
+        fprintf(stderr, "Binary sequence file is too short for its header\n");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(&header, data, sizeof(struct sequenceFileHeader));
+
+    size_t elementSize = elementTypeSize(header.elementType);
+    if(elementSize == 0 || elementSize != header.elementSize){
+        fprintf(stderr, "Binary sequence file has element type %u of size "
+            "%u, which this machine can't read\n", header.elementType,
+            header.elementSize);
+        exit(EXIT_FAILURE);
+    }
+    size_t available = (length - sizeof(struct sequenceFileHeader)) /
+        elementSize;
+    size_t valueCount = header.dimensions;
+    if(valueCount == 0){
+        valueCount = 1;
+    }
+    valueCount *= header.length;
+    if(header.length == 0 || header.length > INT_MAX ||
+        header.dimensions > INT_MAX / header.length ||
+        valueCount > available){
+        fprintf(stderr, "Binary sequence file claims %llu values, but has "
+            "room for %zu\n", (unsigned long long) valueCount, available);
+        exit(EXIT_FAILURE);
+    }
+
+    const char *values = data + sizeof(struct sequenceFileHeader);
+    *seqLen = (int) header.length;
+    *dimensions = (header.dimensions == 0) ? 1 : (int) header.dimensions;
+    if(header.elementType == SEQUENCE_LONG_DOUBLE && inPlace){
+        *seq = (long double *) values;
+        return 1;
+    }
+
+    long double *seqLocal = (long double *) malloc(sizeof(long double) *
+        valueCount);
+    assert(seqLocal);
+    if(header.elementType == SEQUENCE_FLOAT){
+        const float *floats = (const float *) values;
+        for(size_t v = 0; v < valueCount; v++){
+            seqLocal[v] = floats[v];
+        }
+    } else if(header.elementType == SEQUENCE_DOUBLE){
+        const double *doubles = (const double *) values;
+        for(size_t v = 0; v < valueCount; v++){
+            seqLocal[v] = doubles[v];
+        }
+    } else {
+        memcpy(seqLocal, values, sizeof(long double) * valueCount);
+    }
+    *seq = seqLocal;
+
+    return 0;
+}
+
+static int parseDimensionsHeader(const char *data, size_t length,
+    size_t *bodyStart){
+    size_t c = 0;
+    while(c < length && isspace((unsigned char) data[c])){
+        c++;
+    }
+    size_t keywordLength = strlen(TEXT_DIMENSIONS_HEADER);
+    if(length - c < keywordLength || 
+        memcmp(data + c, TEXT_DIMENSIONS_HEADER, keywordLength) != 0){
+        return 0;
+    }
+    c += keywordLength;
+    while(c < length && (data[c] == ' ' || data[c] == '\t')){
+        c++;
+    }
+    long dimensions = 0;
+    int digits = 0;
+    while(c < length && isdigit((unsigned char) data[c]) && 
+        dimensions <= INT_MAX){
+        dimensions = dimensions * 10 + (data[c] - '0');
+        digits++;
+        c++;
+    }
+    while(c < length && data[c] != '\n' && isspace((unsigned char) data[c])){
+        c++;
+    }
+    if(digits == 0 || dimensions < 1 || dimensions > INT_MAX || 
+        (c < length && data[c] != '\n')){
+        fprintf(stderr, "The sequence file's header should be \"%s\" "
+            "followed by a number of dimensions of at least 1\n", 
+            TEXT_DIMENSIONS_HEADER);
+        exit(EXIT_FAILURE);
+    }
+    *bodyStart = c;
+    return (int) dimensions;
+}
+
+static int parseMultivariateText(const char *data, size_t length,
+    int *seqLen, long double **seq){
+    size_t lineStart = 0;
+    int expected = parseDimensionsHeader(data, length, &lineStart);
+    if(expected == 0){
+        *seqLen = parseSequenceText(data, length, seq);
+        return 1;
+    }
+    int dimensions = 0;
+    long double *values = NULL;
+    while(lineStart < length){
+        const char *newline = (const char *) memchr(data + lineStart, '\n',
+            length - lineStart);
+        size_t lineEnd = newline ? (size_t) (newline - data) : length;
+        int blank = 1;
+        for(size_t c = lineStart; c < lineEnd && blank; c++){
+            blank = isspace((unsigned char) data[c]);
+        }
+        if(! blank){
+            long double *line;
+            int lineLength = parseSequenceText(data + lineStart,
+                lineEnd - lineStart, &line);
+            if(dimensions == 0){
+                *seqLen = lineLength;
+                values = line;
+            } else {
+                if(lineLength != *seqLen){
+                    fprintf(stderr, "Line %d of the sequence file has %d "
+                        "values, but the first has %d\n", dimensions + 1,
+                        lineLength, *seqLen);
+                    exit(EXIT_FAILURE);
+                }
+                values = (long double *) realloc(values,
+                    sizeof(long double) * (size_t) (dimensions + 1) *
+                    lineLength);
+                assert(values);
+                memcpy(values + (size_t) dimensions * lineLength, line,
+                    sizeof(long double) * lineLength);
+                free(line);
+            }
+            dimensions++;
+        }
+        lineStart = lineEnd + 1;
+    }
+    if(dimensions != expected){
+        fprintf(stderr, "The sequence file's header gives %d dimensions, "
+            "but it has %d lines of values\n", expected, dimensions);
+        exit(EXIT_FAILURE);
+    }
+    *seq = values;
+    return dimensions;
+}
+
+static char *readWholeFile(FILE *seqFile, size_t *length){
+    size_t allocated = READ_CHUNK_SIZE;
+    size_t used = 0;
+    char *data = (char *) malloc(allocated);
+    assert(data);
+    size_t bytesRead;
+    while((bytesRead = fread(data + used, 1, allocated - used, seqFile)) > 0){
+        used += bytesRead;
+        if(used == allocated){
+            allocated *= 2;
+            data = (char *) realloc(data, allocated);
+            assert(data);
+        }
+    }
+    if(ferror(seqFile)){
+        /* Encountered an error. */
+        perror("Encountered error reading sequence file");
+        exit(EXIT_FAILURE);
+    }
+    /* Assume file contains at least one character. */
+    assert(used > 0);
+
+    *length = used;
+    return data;
+}
+
+struct sequenceMapping *loadSequence(FILE *seqFile, int *seqLen,
+    long double **seq){
+    int dimensions;
+    struct sequenceMapping *mapping = loadMultivariateSequence(seqFile, 
+        seqLen, &dimensions, seq);
+    if(dimensions > 1){
+        fprintf(stderr, "Sequence file has %d values per step, where only "
+            "one was expected\n", dimensions);
+        exit(EXIT_FAILURE);
+    }
+    return mapping;
+}
+
+struct sequenceMapping *loadMultivariateSequence(FILE *seqFile, int *seqLen,
+    int *dimensions, long double **seq){
+    struct stat fileStat;
+    int fd = fileno(seqFile);
+
+    /* Map regular files read from the start, so they're used in place. */
+    if(fd != -1 && fstat(fd, &fileStat) == 0 && S_ISREG(fileStat.st_mode) &&
+        fileStat.st_size > 0 && ftell(seqFile) == 0){
+        size_t length = fileStat.st_size;
+        char *data = (char *) mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd,
+            0);
+        if(data != MAP_FAILED){
+            madvise(data, length, MADV_SEQUENTIAL);
+            if(! isBinarySequence(data, length)){
+                *dimensions = parseMultivariateText(data, length, seqLen, 
+                    seq);
+            } else if(decodeBinarySequence(data, length, 1, seqLen, 
+                dimensions, seq)){
+                /* Keep the file mapped for as long as seq is used. */
+                struct sequenceMapping *mapping = (struct sequenceMapping *)
+                    malloc(sizeof(struct sequenceMapping));
+                assert(mapping);
+                mapping->address = data;
+                mapping->length = length;
+                return mapping;
+            }
+            munmap(data, length);
+            return NULL;
+        }
+    }
+
+    /* Otherwise (e.g. a pipe), read the file in. */
+    size_t length;
+    char *data = readWholeFile(seqFile, &length);
+    if(isBinarySequence(data, length)){
+        decodeBinarySequence(data, length, 0, seqLen, dimensions, seq);
+    } else {
+        *dimensions = parseMultivariateText(data, length, seqLen, seq);
+    }
+    free(data);
+
+    return NULL;
+}
+
+void freeSequenceMapping(struct sequenceMapping *mapping){
+    if(mapping){
+        munmap(mapping->address, mapping->length);
+        free(mapping);
+    }
+}
+
+void writeBinarySequence(FILE *seqFile, long double *seq, int seqLen,
+    int dimensions, enum sequenceElementType elementType){
+    struct sequenceFileHeader header;
+    memset(&header, 0, sizeof(struct sequenceFileHeader));
+    memcpy(header.magic, SEQUENCE_FILE_MAGIC, SEQUENCE_FILE_MAGIC_SIZE);
+    header.elementType = elementType;
+    header.elementSize = elementTypeSize(elementType);
+    assert(header.elementSize > 0);
+    header.length = seqLen;
+    header.dimensions = dimensions;
+    fwrite(&header, sizeof(struct sequenceFileHeader), 1, seqFile);
+
+    for(size_t i = 0; i < (size_t) dimensions * seqLen; i++){
+        if(elementType == SEQUENCE_FLOAT){
+            float value = seq[i];
+            fwrite(&value, sizeof(float), 1, seqFile);
+        } else if(elementType == SEQUENCE_DOUBLE){
+            double value = seq[i];
+            fwrite(&value, sizeof(double), 1, seqFile);
+        } else {
+            /* Zero the unused bytes, rather than writing whatever's there. */
+            long double value;
+            memset(&value, 0, sizeof(long double));
+            value = seq[i];
+            fwrite(&value, sizeof(long double), 1, seqFile);
+        }
+    }
+}
+
+void writeTextSequence(FILE *seqFile, long double *seq, int seqLen,
+    int dimensions, enum sequenceElementType elementType){
+    int digits = LONG_DOUBLE_DIGITS;
+    if(elementType == SEQUENCE_FLOAT){
+        digits = FLOAT_DIGITS;
+    } else if(elementType == SEQUENCE_DOUBLE){
+        digits = DOUBLE_DIGITS;
+    }
+    if(dimensions > 1){
+        fprintf(seqFile, "%s %d\n", TEXT_DIMENSIONS_HEADER, dimensions);
+    }
+    for(int d = 0; d < dimensions; d++){
+        long double *line = seq + (size_t) d * seqLen;
+        for(int i = 0; i < seqLen; i++){
+            fprintf(seqFile, "%s%.*LE", (i == 0) ? "" : TEXT_SEPARATOR,
+                digits - 1, line[i]);
+        }
+        fprintf(seqFile, "\n");
+    }
+}
@@ -0,0 +1,112 @@
+/*
+    Header for module which reads and writes sequence files, either in
+        the comma-separated text format or in a binary format.
+
+    A binary sequence file is a struct sequenceFileHeader followed by
+        length packed values of the given element type, in the byte order
+        of the machine that wrote it. Files are recognised as binary by the
+        magic at their start, so either format can be given wherever a
+        sequence file is read.
+
+    A multivariate sequence has several values per step. It is stored as 
+        structure-of-arrays, one run of length values per dimension, both 
+        in memory and in binary files. A text file is multivariate only if 
+        its first line is a header of "dimensions" and their number, e.g. 
+        "dimensions 2", after which each dimension is a line of its own. 
+        Without the header a text file is univariate, its values free to 
+        wrap across lines.
+*/
+
+#ifndef SEQUENCEFILE_H
+#define SEQUENCEFILE_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/* The first bytes of every binary sequence file. */
+#define SEQUENCE_FILE_MAGIC "DTWSEQ1"
+#define SEQUENCE_FILE_MAGIC_SIZE 8
+
+/* How each value of a binary sequence file is stored. */
+enum sequenceElementType {
+    SEQUENCE_FLOAT = 1,
+    SEQUENCE_DOUBLE = 2,
+    SEQUENCE_LONG_DOUBLE = 3
+};
+
+/* Starts a binary sequence file, 32 bytes so long double values after it
+    are aligned. */
+struct sequenceFileHeader {
+    char magic[SEQUENCE_FILE_MAGIC_SIZE];
+    /* An enum sequenceElementType. */
+    uint32_t elementType;
+    /* sizeof the element type where the file was written. */
+    uint32_t elementSize;
+    /* The number of steps. */
+    uint64_t length;
+    /* Values per step, 0 in files from before multivariate sequences, 
+        which are read as 1. */
+    uint32_t dimensions;
+    uint32_t reserved;
+};
+
+/* The first bytes of every binary matrix file. */
+#define MATRIX_FILE_MAGIC "DTWMAT1"
+
+/* Starts a binary matrix file, followed by rows * columns values of the 
+    given element type, row after row. */
+struct matrixFileHeader {
+    char magic[SEQUENCE_FILE_MAGIC_SIZE];
+    /* An enum sequenceElementType. */
+    uint32_t elementType;
+    /* sizeof the element type where the file was written. */
+    uint32_t elementSize;
+    uint64_t rows;
+    uint64_t columns;
+};
+
+/* A binary sequence file mapped into memory. */
+struct sequenceMapping;
+
+/*
+    Reads the sequence in the given file, in either format, setting seqLen to
+    its length. Regular files are mapped with mmap rather than copied in.
+    Exits if the sequence is multivariate.
+
+    If the file is a binary file of long doubles, seq points straight into
+    the mapped file, which is returned and must be released with
+    freeSequenceMapping once seq is no longer needed. Otherwise NULL is
+    returned and seq is set to a newly allocated array.
+*/
+struct sequenceMapping *loadSequence(FILE *seqFile, int *seqLen,
+    long double **seq);
+
+/*
+    Same as loadSequence, but also reads multivariate sequences, setting 
+    dimensions to their values per step. seq then holds dimensions runs of 
+    seqLen values.
+*/
+struct sequenceMapping *loadMultivariateSequence(FILE *seqFile, int *seqLen,
+    int *dimensions, long double **seq);
+
+/* Unmaps a sequence returned by loadSequence. */
+void freeSequenceMapping(struct sequenceMapping *mapping);
+
+/*
+    Writes the given sequence of dimensions runs of seqLen values to the 
+    given file in the binary format, with values stored as the given 
+    element type.
+*/
+void writeBinarySequence(FILE *seqFile, long double *seq, int seqLen,
+    int dimensions, enum sequenceElementType elementType);
+
+/*
+    Writes the given sequence of dimensions runs of seqLen values to the 
+    given file in the text format, a line per dimension after a dimensions 
+    header if there is more than one, with enough digits that reading it 
+    back gives values of the given element type exactly.
+*/
+void writeTextSequence(FILE *seqFile, long double *seq, int seqLen,
+    int dimensions, enum sequenceElementType elementType);
+
+#endif
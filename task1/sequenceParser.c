@@ -0,0 +1,234 @@
+/*
+    Implementation for module which parses the comma-separated text
+        sequence format in a single pass.
+
+    A decimal value with at most EXACT_DIGITS significant digits has a
+        mantissa which is exactly representable as a long double, as is
+        every power of ten up to 10^EXACT_POWER. Multiplying or dividing
+        the two is then a single correctly rounded operation, which gives
+        exactly the value strtold would, so only values outside these
+        limits need strtold itself.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <float.h>
+#include "sequenceParser.h"
+
+#if LDBL_MANT_DIG >= 64
+/* 10^19 < 2^64 and 5^27 < 2^64. */
+#define EXACT_DIGITS 19
+#define EXACT_POWER 27
+#else
+/* long double is only a double: 10^15 < 2^53 and 5^22 < 2^53. */
+#define EXACT_DIGITS 15
+#define EXACT_POWER 22
+#endif
+
+/* Exponents beyond this are left to strtold, so stop accumulating. */
+#define EXPONENT_LIMIT 100000
+
+/* Longest value copied to the stack for strtold before using the heap. */
+#define FALLBACK_BUFFER_SIZE 64
+
+/* Values to allocate space for per byte of text initially. */
+#define BYTES_PER_VALUE_ESTIMATE 8
+
+static const long double powersOfTen[] = {
+    1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L, 1e7L, 1e8L, 1e9L,
+    1e10L, 1e11L, 1e12L, 1e13L, 1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L,
+    1e20L, 1e21L, 1e22L, 1e23L, 1e24L, 1e25L, 1e26L, 1e27L
+};
+
+/* Returns whether c is whitespace as isspace would in the C locale. */
+static inline int isSpace(char c);
+
+/* Returns the first non-whitespace character at or after p. */
+static inline const char *skipSpace(const char *p, const char *end);
+
+/*
+    Converts the decimal value starting at p, setting value and returning
+    the character after it. Returns NULL if the value can't be converted
+    exactly this way and strtold is needed.
+*/
+static const char *parseExactDecimal(const char *p, const char *end,
+    long double *value);
+
+/*
+    Converts the value starting at p with strtold, setting value and
+    returning the character after it and any trailing whitespace.
+*/
+static const char *parseWithStrtold(const char *p, const char *end,
+    long double *value);
+
+static inline int isSpace(char c){
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' ||
+        c == '\f';
+}
+
+static inline const char *skipSpace(const char *p, const char *end){
+    while(p < end && isSpace(*p)){
+        p++;
+    }
+    return p;
+}
+
+static const char *parseExactDecimal(const char *p, const char *end,
+    long double *value){
+    int negative = 0;
+    unsigned long long mantissa = 0;
+    int digits = 0;
+    int sawDigit = 0;
+    int exponent = 0;
+
+    if(p < end && (*p == '-' || *p == '+')){
+        negative = (*p == '-');
+        p++;
+    }
+
+    /* Leading zeros aren't significant, so don't count towards digits. */
+    while(p < end && *p >= '0' && *p <= '9'){
+        sawDigit = 1;
+        if(mantissa || *p != '0'){
+            if(digits == EXACT_DIGITS){
+                return NULL;
+            }
+            mantissa = mantissa * 10 + (*p - '0');
+            digits++;
+        }
+        p++;
+    }
+    if(p < end && *p == '.'){
+        p++;
+        while(p < end && *p >= '0' && *p <= '9'){
+            sawDigit = 1;
+            if(mantissa || *p != '0'){
+                if(digits == EXACT_DIGITS){
+                    return NULL;
+                }
+                mantissa = mantissa * 10 + (*p - '0');
+                digits++;
+            }
+            exponent--;
+            p++;
+        }
+    }
+    if(! sawDigit){
+        /* e.g. inf or nan. */
+        return NULL;
+    }
+
+    if(p < end && (*p == 'e' || *p == 'E')){
+        p++;
+        int exponentNegative = 0;
+        if(p < end && (*p == '-' || *p == '+')){
+            exponentNegative = (*p == '-');
+            p++;
+        }
+        if(p == end || *p < '0' || *p > '9'){
+            return NULL;
+        }
+        int written = 0;
+        while(p < end && *p >= '0' && *p <= '9'){
+            if(written < EXPONENT_LIMIT){
+                written = written * 10 + (*p - '0');
+            }
+            p++;
+        }
+        exponent += exponentNegative ? -written : written;
+    }
+
+    if(mantissa == 0){
+        *value = 0.0L;
+    } else if(exponent > EXACT_POWER || exponent < -EXACT_POWER){
+        return NULL;
+    } else if(exponent >= 0){
+        *value = (long double) mantissa * powersOfTen[exponent];
+    } else {
+        *value = (long double) mantissa / powersOfTen[-exponent];
+    }
+    if(negative){
+        *value = -*value;
+    }
+
+    return p;
+}
+
+static const char *parseWithStrtold(const char *p, const char *end,
+    long double *value){
+    /* The value runs up to the next comma, which strtold must not need
+        the text to be null-terminated to find. */
+    const char *valueEnd = memchr(p, ',', end - p);
+    if(! valueEnd){
+        valueEnd = end;
+    }
+    size_t valueLength = valueEnd - p;
+
+    char stackBuffer[FALLBACK_BUFFER_SIZE];
+    char *buffer = stackBuffer;
+    if(valueLength >= FALLBACK_BUFFER_SIZE){
+        buffer = (char *) malloc(valueLength + 1);
+        assert(buffer);
+    }
+    memcpy(buffer, p, valueLength);
+    buffer[valueLength] = '\0';
+
+    char *converted;
+    *value = strtold(buffer, &converted);
+    assert(converted != buffer);
+    const char *after = skipSpace(p + (converted - buffer), end);
+    assert(after == valueEnd);
+
+    if(buffer != stackBuffer){
+        free(buffer);
+    }
+
+    return after;
+}
+
+int parseSequenceText(const char *text, size_t length, long double **seq){
+    const char *p = text;
+    const char *end = text + length;
+
+    int allocated = length / BYTES_PER_VALUE_ESTIMATE + 1;
+    long double *values = (long double *) malloc(sizeof(long double) *
+        allocated);
+    assert(values);
+    int count = 0;
+
+    while(1){
+        p = skipSpace(p, end);
+        /* There must be a value before the end and after every comma. */
+        assert(p < end);
+
+        if(count == allocated){
+            allocated *= 2;
+            values = (long double *) realloc(values, sizeof(long double) *
+                allocated);
+            assert(values);
+        }
+        const char *next = parseExactDecimal(p, end, &values[count]);
+        if(next){
+            next = skipSpace(next, end);
+        }
+        if(! next || (next < end && *next != ',')){
+            next = parseWithStrtold(p, end, &values[count]);
+        }
+        count++;
+        p = next;
+
+        if(p == end){
+            break;
+        }
+        assert(*p == ',');
+        p++;
+    }
+
+    /* Give back what the estimate over-allocated. */
+    values = (long double *) realloc(values, sizeof(long double) * count);
+    assert(values);
+    *seq = values;
+
+    return count;
+}
@@ -0,0 +1,24 @@
+/*
+    Header for module which parses the comma-separated text sequence
+        format in a single pass, without going through scanf.
+*/
+
+#ifndef SEQUENCEPARSER_H
+#define SEQUENCEPARSER_H
+
+#include <stddef.h>
+
+/*
+    Parses the comma-separated values in the first length characters of
+    text, which need not be null-terminated. Whitespace around values and
+    commas is skipped. Sets seq to a newly allocated array of the values and
+    returns how many there are.
+
+    Values are the same as strtold (and so sscanf's %Lf) would give: plain
+    decimals short enough to convert exactly are converted directly, and
+    anything else (long mantissas, large exponents, inf, nan, hex) falls
+    back to strtold.
+*/
+int parseSequenceText(const char *text, size_t length, long double **seq);
+
+#endif
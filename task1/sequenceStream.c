@@ -0,0 +1,155 @@
+/*
+    Implementation for module which reads a comma-separated text sequence
+        a batch of values at a time.
+
+    The file is read with read(2) rather than stdio, which returns whatever
+        has arrived instead of waiting to fill a buffer, so values from a
+        pipe are seen as soon as they are written.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "sequenceParser.h"
+#include "sequenceStream.h"
+
+/* Bytes read at a time. */
+#define STREAM_CHUNK 4096
+/* How long to wait for a followed file to grow. */
+#define STREAM_POLL_NANOSECONDS 200000000L
+
+struct sequenceStream {
+    int fd;
+    int ownsFd;
+    int follow;
+    /* 1 once the end has been read, and any last value returned. */
+    int ended;
+    /* Text read but not yet returned, as its last value may be partial. */
+    char *pending;
+    size_t pendingLength;
+    size_t pendingAllocated;
+};
+
+/*
+    Parses the values in the first length characters of text, ignoring a
+    comma at either end, as for readSequenceStream. Returns 0 if there are
+    none, e.g. for a blank line.
+*/
+static int parseStreamText(char *text, size_t length, long double **values);
+
+struct sequenceStream *openSequenceStream(char *fileName, int follow){
+    struct sequenceStream *s = (struct sequenceStream *)
+        malloc(sizeof(struct sequenceStream));
+    assert(s);
+    if(strcmp(fileName, SEQUENCE_STREAM_STDIN) == 0){
+        s->fd = STDIN_FILENO;
+        s->ownsFd = 0;
+        /* There is nothing to wait on once stdin is closed. */
+        s->follow = 0;
+    } else {
+        s->fd = open(fileName, O_RDONLY);
+        if(s->fd < 0){
+            free(s);
+            return NULL;
+        }
+        s->ownsFd = 1;
+        s->follow = follow;
+    }
+    s->ended = 0;
+    s->pendingLength = 0;
+    s->pendingAllocated = 2 * STREAM_CHUNK;
+    s->pending = (char *) malloc(s->pendingAllocated);
+    assert(s->pending);
+
+    return s;
+}
+
+int readSequenceStream(struct sequenceStream *s, long double **values){
+    struct timespec poll = {0, STREAM_POLL_NANOSECONDS};
+
+    while(! s->ended){
+        if(s->pendingLength + STREAM_CHUNK > s->pendingAllocated){
+            s->pendingAllocated *= 2;
+            s->pending = (char *) realloc(s->pending, s->pendingAllocated);
+            assert(s->pending);
+        }
+        ssize_t got = read(s->fd, s->pending + s->pendingLength, STREAM_CHUNK);
+        if(got < 0 && errno == EINTR){
+            continue;
+        }
+        if(got < 0){
+            perror("Reason for stream read failure");
+        }
+        if(got == 0 && s->follow){
+            /* Wait for the file to grow. */
+            nanosleep(&poll, NULL);
+            continue;
+        }
+        if(got <= 0){
+            /* At the end, the last value needs nothing after it. */
+            s->ended = 1;
+            int count = parseStreamText(s->pending, s->pendingLength, values);
+            s->pendingLength = 0;
+            if(count > 0){
+                return count;
+            }
+            break;
+        }
+        s->pendingLength += got;
+
+        size_t complete = s->pendingLength;
+        while(complete > 0 && s->pending[complete - 1] != ',' &&
+            s->pending[complete - 1] != '\n'){
+            complete--;
+        }
+        if(complete == 0){
+            continue;
+        }
+        int count = parseStreamText(s->pending, complete - 1, values);
+        memmove(s->pending, s->pending + complete,
+            s->pendingLength - complete);
+        s->pendingLength -= complete;
+        if(count > 0){
+            return count;
+        }
+    }
+
+    return 0;
+}
+
+void closeSequenceStream(struct sequenceStream *s){
+    if(! s){
+        return;
+    }
+    if(s->ownsFd){
+        close(s->fd);
+    }
+    free(s->pending);
+    free(s);
+}
+
+static int parseStreamText(char *text, size_t length, long double **values){
+    size_t start = 0;
+    while(start < length && isspace((unsigned char) text[start])){
+        start++;
+    }
+    if(start < length && text[start] == ','){
+        start++;
+    }
+    while(length > start && isspace((unsigned char) text[length - 1])){
+        length--;
+    }
+    if(length > start && text[length - 1] == ','){
+        length--;
+    }
+    if(length <= start){
+        return 0;
+    }
+
+    return parseSequenceText(text + start, length - start, values);
+}
@@ -0,0 +1,37 @@
+/*
+    Header for module which reads a comma-separated text sequence a batch
+        of values at a time, as they arrive, from a file or stdin, without
+        ever holding the whole sequence.
+
+    A value is complete once a comma or newline follows it, or the stream
+        ends. Text after the last complete value is kept until the rest of
+        the value arrives.
+*/
+
+#ifndef SEQUENCESTREAM_H
+#define SEQUENCESTREAM_H
+
+/* Name of the stream which reads stdin. */
+#define SEQUENCE_STREAM_STDIN "-"
+
+struct sequenceStream;
+
+/*
+    Opens the sequence in the given file, or stdin if SEQUENCE_STREAM_STDIN.
+    If follow is set, a file which has no more values is waited on to grow,
+    like tail -f, instead of ending the stream. stdin always ends when it is
+    closed. Returns NULL if the file can't be opened.
+*/
+struct sequenceStream *openSequenceStream(char *fileName, int follow);
+
+/*
+    Waits for the next complete values, setting values to a newly allocated
+    array of them and returning how many there are. Returns 0, leaving
+    values unset, once the stream has ended.
+*/
+int readSequenceStream(struct sequenceStream *s, long double **values);
+
+/* Closes the stream and frees all memory allocated for it. */
+void closeSequenceStream(struct sequenceStream *s);
+
+#endif
@@ -0,0 +1,793 @@
+/*
+    Implementation for module which computes DTW matrices in float or
+        double precision along anti-diagonals.
+
+    Cell (i, j) lies on anti-diagonal d = i + j and only needs cells
+        (i - 1, j) and (i, j - 1) from anti-diagonal d - 1 and cell
+        (i - 1, j - 1) from anti-diagonal d - 2. Storing each anti-diagonal
+        by row index i, and sequence B reversed, makes all of these
+        contiguous, so a whole anti-diagonal is one element-wise kernel:
+
+            out[k] = |x[k] - y[k]| + min(up[k], min(left[k], diag[k]))
+
+    The kernel is picked once, using AVX2 where the CPU supports it,
+        otherwise SSE2, otherwise plain C.
+
+    The integer kernels compute the same recurrence on whole-number 
+        sequences, shifted so their smallest value is 0, with 16 or 32-bit 
+        cells whose largest value (INT16_INFINITY or INT32_INFINITY) stands 
+        for infinity. Sums saturate at it, with a saturating add for 16 
+        bits (16 cells per AVX2 instruction) and a minimum for 32 bits.
+
+    The row kernels compute the same recurrence for a row of cells whose
+        neighbours are all already known, with x the same for every cell,
+        as in each row of a Part F layer.
+
+    The accumulating kernels add one dimension's share of the L1 or squared
+        L2 distance between one step of a multivariate sequence and a run
+        of steps of another, which are contiguous when stored as
+        structure-of-arrays.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <stdint.h>
+#include <math.h>
+#include "problem.h"
+#include "simdKernel.h"
+
+/* The values standing for infinity in integer cells. Half the largest 
+    32-bit integer leaves room to add any cost before saturating. */
+#define INT16_INFINITY INT16_MAX
+#define INT32_INFINITY (INT32_MAX / 2)
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+/* Computes one anti-diagonal of length count in the given precision. */
+typedef void (*doubleKernel)(double *out, const double *x, const double *y,
+    const double *up, const double *left, const double *diag, int count);
+typedef void (*floatKernel)(float *out, const float *x, const float *y,
+    const float *up, const float *left, const float *diag, int count);
+
+static void doubleKernelScalar(double *out, const double *x, const double *y,
+    const double *up, const double *left, const double *diag, int count){
+    for(int k = 0; k < count; k++){
+        out[k] = fabs(x[k] - y[k]) + fmin(up[k], fmin(left[k], diag[k]));
+    }
+}
+
+static void floatKernelScalar(float *out, const float *x, const float *y,
+    const float *up, const float *left, const float *diag, int count){
+    for(int k = 0; k < count; k++){
+        out[k] = fabsf(x[k] - y[k]) + fminf(up[k], fminf(left[k], diag[k]));
+    }
+}
+
+typedef void (*int16Kernel)(int16_t *out, const int16_t *x, 
+    const int16_t *y, const int16_t *up, const int16_t *left, 
+    const int16_t *diag, int count);
+typedef void (*int32Kernel)(int32_t *out, const int32_t *x, 
+    const int32_t *y, const int32_t *up, const int32_t *left, 
+    const int32_t *diag, int count);
+
+/*
+    Defines the plain C integer kernel in the given type, saturating at INF.
+    Costs and sums both fit in an int, as no cost reaches INF.
+*/
+#define DEFINE_INTEGER_KERNEL_SCALAR(TYPE, SUFFIX, INF)                        \
+static void SUFFIX##KernelScalar(TYPE *out, const TYPE *x, const TYPE *y,      \
+    const TYPE *up, const TYPE *left, const TYPE *diag, int count){            \
+    for(int k = 0; k < count; k++){                                            \
+        int best = (up[k] < left[k]) ? up[k] : left[k];                        \
+        if(diag[k] < best){                                                    \
+            best = diag[k];                                                    \
+        }                                                                      \
+        int cell = abs((int) x[k] - (int) y[k]) + best;                        \
+        out[k] = (TYPE) ((cell < (INF)) ? cell : (INF));                       \
+    }                                                                          \
+}
+
+DEFINE_INTEGER_KERNEL_SCALAR(int16_t, int16, INT16_INFINITY)
+DEFINE_INTEGER_KERNEL_SCALAR(int32_t, int32, INT32_INFINITY)
+
+/* Computes one row of length count in the given precision. */
+typedef void (*doubleRowKernel)(double *out, double x, const double *y,
+    const double *up, const double *left, const double *diag, int count);
+typedef void (*floatRowKernel)(float *out, float x, const float *y,
+    const float *up, const float *left, const float *diag, int count);
+
+static void doubleRowKernelScalar(double *out, double x, const double *y,
+    const double *up, const double *left, const double *diag, int count){
+    for(int k = 0; k < count; k++){
+        out[k] = fabs(x - y[k]) + fmin(up[k], fmin(left[k], diag[k]));
+    }
+}
+
+static void floatRowKernelScalar(float *out, float x, const float *y,
+    const float *up, const float *left, const float *diag, int count){
+    for(int k = 0; k < count; k++){
+        out[k] = fabsf(x - y[k]) + fminf(up[k], fminf(left[k], diag[k]));
+    }
+}
+
+/* Adds one dimension's distances to a run of count sums. */
+typedef void (*accumulateKernel)(double *sum, double x, const double *y,
+    int count);
+
+static void accumulateL1Scalar(double *sum, double x, const double *y,
+    int count){
+    for(int k = 0; k < count; k++){
+        sum[k] += fabs(x - y[k]);
+    }
+}
+
+static void accumulateL2Scalar(double *sum, double x, const double *y,
+    int count){
+    for(int k = 0; k < count; k++){
+        double difference = x - y[k];
+        sum[k] += difference * difference;
+    }
+}
+
+#ifdef SIMD_X86
+__attribute__((target("sse2")))
+static void doubleKernelSSE2(double *out, const double *x, const double *y,
+    const double *up, const double *left, const double *diag, int count){
+    const __m128d signMask = _mm_set1_pd(-0.0);
+    int k = 0;
+    for(; k + 2 <= count; k += 2){
+        __m128d cost = _mm_andnot_pd(signMask,
+            _mm_sub_pd(_mm_loadu_pd(x + k), _mm_loadu_pd(y + k)));
+        __m128d best = _mm_min_pd(_mm_loadu_pd(up + k),
+            _mm_min_pd(_mm_loadu_pd(left + k), _mm_loadu_pd(diag + k)));
+        _mm_storeu_pd(out + k, _mm_add_pd(cost, best));
+    }
+    doubleKernelScalar(out + k, x + k, y + k, up + k, left + k, diag + k,
+        count - k);
+}
+
+__attribute__((target("sse2")))
+static void floatKernelSSE2(float *out, const float *x, const float *y,
+    const float *up, const float *left, const float *diag, int count){
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    int k = 0;
+    for(; k + 4 <= count; k += 4){
+        __m128 cost = _mm_andnot_ps(signMask,
+            _mm_sub_ps(_mm_loadu_ps(x + k), _mm_loadu_ps(y + k)));
+        __m128 best = _mm_min_ps(_mm_loadu_ps(up + k),
+            _mm_min_ps(_mm_loadu_ps(left + k), _mm_loadu_ps(diag + k)));
+        _mm_storeu_ps(out + k, _mm_add_ps(cost, best));
+    }
+    floatKernelScalar(out + k, x + k, y + k, up + k, left + k, diag + k,
+        count - k);
+}
+
+__attribute__((target("avx2")))
+static void doubleKernelAVX2(double *out, const double *x, const double *y,
+    const double *up, const double *left, const double *diag, int count){
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+    int k = 0;
+    for(; k + 4 <= count; k += 4){
+        __m256d cost = _mm256_andnot_pd(signMask,
+            _mm256_sub_pd(_mm256_loadu_pd(x + k), _mm256_loadu_pd(y + k)));
+        __m256d best = _mm256_min_pd(_mm256_loadu_pd(up + k),
+            _mm256_min_pd(_mm256_loadu_pd(left + k), _mm256_loadu_pd(diag + k)));
+        _mm256_storeu_pd(out + k, _mm256_add_pd(cost, best));
+    }
+    doubleKernelScalar(out + k, x + k, y + k, up + k, left + k, diag + k,
+        count - k);
+}
+
+__attribute__((target("avx2")))
+static void floatKernelAVX2(float *out, const float *x, const float *y,
+    const float *up, const float *left, const float *diag, int count){
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    int k = 0;
+    for(; k + 8 <= count; k += 8){
+        __m256 cost = _mm256_andnot_ps(signMask,
+            _mm256_sub_ps(_mm256_loadu_ps(x + k), _mm256_loadu_ps(y + k)));
+        __m256 best = _mm256_min_ps(_mm256_loadu_ps(up + k),
+            _mm256_min_ps(_mm256_loadu_ps(left + k), _mm256_loadu_ps(diag + k)));
+        _mm256_storeu_ps(out + k, _mm256_add_ps(cost, best));
+    }
+    floatKernelScalar(out + k, x + k, y + k, up + k, left + k, diag + k,
+        count - k);
+}
+
+__attribute__((target("sse2")))
+static void doubleRowKernelSSE2(double *out, double x, const double *y,
+    const double *up, const double *left, const double *diag, int count){
+    const __m128d signMask = _mm_set1_pd(-0.0);
+    const __m128d xs = _mm_set1_pd(x);
+    int k = 0;
+    for(; k + 2 <= count; k += 2){
+        __m128d cost = _mm_andnot_pd(signMask,
+            _mm_sub_pd(xs, _mm_loadu_pd(y + k)));
+        __m128d best = _mm_min_pd(_mm_loadu_pd(up + k),
+            _mm_min_pd(_mm_loadu_pd(left + k), _mm_loadu_pd(diag + k)));
+        _mm_storeu_pd(out + k, _mm_add_pd(cost, best));
+    }
+    doubleRowKernelScalar(out + k, x, y + k, up + k, left + k, diag + k,
+        count - k);
+}
+
+__attribute__((target("sse2")))
+static void floatRowKernelSSE2(float *out, float x, const float *y,
+    const float *up, const float *left, const float *diag, int count){
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 xs = _mm_set1_ps(x);
+    int k = 0;
+    for(; k + 4 <= count; k += 4){
+        __m128 cost = _mm_andnot_ps(signMask,
+            _mm_sub_ps(xs, _mm_loadu_ps(y + k)));
+        __m128 best = _mm_min_ps(_mm_loadu_ps(up + k),
+            _mm_min_ps(_mm_loadu_ps(left + k), _mm_loadu_ps(diag + k)));
+        _mm_storeu_ps(out + k, _mm_add_ps(cost, best));
+    }
+    floatRowKernelScalar(out + k, x, y + k, up + k, left + k, diag + k,
+        count - k);
+}
+
+__attribute__((target("avx2")))
+static void doubleRowKernelAVX2(double *out, double x, const double *y,
+    const double *up, const double *left, const double *diag, int count){
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+    const __m256d xs = _mm256_set1_pd(x);
+    int k = 0;
+    for(; k + 4 <= count; k += 4){
+        __m256d cost = _mm256_andnot_pd(signMask,
+            _mm256_sub_pd(xs, _mm256_loadu_pd(y + k)));
+        __m256d best = _mm256_min_pd(_mm256_loadu_pd(up + k),
+            _mm256_min_pd(_mm256_loadu_pd(left + k), _mm256_loadu_pd(diag + k)));
+        _mm256_storeu_pd(out + k, _mm256_add_pd(cost, best));
+    }
+    doubleRowKernelScalar(out + k, x, y + k, up + k, left + k, diag + k,
+        count - k);
+}
+
+__attribute__((target("avx2")))
+static void floatRowKernelAVX2(float *out, float x, const float *y,
+    const float *up, const float *left, const float *diag, int count){
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    const __m256 xs = _mm256_set1_ps(x);
+    int k = 0;
+    for(; k + 8 <= count; k += 8){
+        __m256 cost = _mm256_andnot_ps(signMask,
+            _mm256_sub_ps(xs, _mm256_loadu_ps(y + k)));
+        __m256 best = _mm256_min_ps(_mm256_loadu_ps(up + k),
+            _mm256_min_ps(_mm256_loadu_ps(left + k), _mm256_loadu_ps(diag + k)));
+        _mm256_storeu_ps(out + k, _mm256_add_ps(cost, best));
+    }
+    floatRowKernelScalar(out + k, x, y + k, up + k, left + k, diag + k,
+        count - k);
+}
+
+__attribute__((target("sse2")))
+static void accumulateL1SSE2(double *sum, double x, const double *y,
+    int count){
+    const __m128d signMask = _mm_set1_pd(-0.0);
+    const __m128d xs = _mm_set1_pd(x);
+    int k = 0;
+    for(; k + 2 <= count; k += 2){
+        __m128d distance = _mm_andnot_pd(signMask,
+            _mm_sub_pd(xs, _mm_loadu_pd(y + k)));
+        _mm_storeu_pd(sum + k, _mm_add_pd(_mm_loadu_pd(sum + k), distance));
+    }
+    accumulateL1Scalar(sum + k, x, y + k, count - k);
+}
+
+__attribute__((target("sse2")))
+static void accumulateL2SSE2(double *sum, double x, const double *y,
+    int count){
+    const __m128d xs = _mm_set1_pd(x);
+    int k = 0;
+    for(; k + 2 <= count; k += 2){
+        __m128d difference = _mm_sub_pd(xs, _mm_loadu_pd(y + k));
+        _mm_storeu_pd(sum + k, _mm_add_pd(_mm_loadu_pd(sum + k),
+            _mm_mul_pd(difference, difference)));
+    }
+    accumulateL2Scalar(sum + k, x, y + k, count - k);
+}
+
+__attribute__((target("avx2")))
+static void accumulateL1AVX2(double *sum, double x, const double *y,
+    int count){
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+    const __m256d xs = _mm256_set1_pd(x);
+    int k = 0;
+    for(; k + 4 <= count; k += 4){
+        __m256d distance = _mm256_andnot_pd(signMask,
+            _mm256_sub_pd(xs, _mm256_loadu_pd(y + k)));
+        _mm256_storeu_pd(sum + k, _mm256_add_pd(_mm256_loadu_pd(sum + k),
+            distance));
+    }
+    accumulateL1Scalar(sum + k, x, y + k, count - k);
+}
+
+__attribute__((target("avx2")))
+static void accumulateL2AVX2(double *sum, double x, const double *y,
+    int count){
+    const __m256d xs = _mm256_set1_pd(x);
+    int k = 0;
+    for(; k + 4 <= count; k += 4){
+        __m256d difference = _mm256_sub_pd(xs, _mm256_loadu_pd(y + k));
+        _mm256_storeu_pd(sum + k, _mm256_add_pd(_mm256_loadu_pd(sum + k),
+            _mm256_mul_pd(difference, difference)));
+    }
+    accumulateL2Scalar(sum + k, x, y + k, count - k);
+}
+#endif
+
+#ifdef SIMD_X86
+__attribute__((target("sse2")))
+static void int16KernelSSE2(int16_t *out, const int16_t *x, const int16_t *y,
+    const int16_t *up, const int16_t *left, const int16_t *diag, int count){
+    const __m128i zero = _mm_setzero_si128();
+    int k = 0;
+    for(; k + 8 <= count; k += 8){
+        __m128i difference = _mm_sub_epi16(
+            _mm_loadu_si128((const __m128i *) (x + k)),
+            _mm_loadu_si128((const __m128i *) (y + k)));
+        __m128i cost = _mm_max_epi16(difference, 
+            _mm_sub_epi16(zero, difference));
+        __m128i best = _mm_min_epi16(
+            _mm_loadu_si128((const __m128i *) (up + k)),
+            _mm_min_epi16(_mm_loadu_si128((const __m128i *) (left + k)),
+                _mm_loadu_si128((const __m128i *) (diag + k))));
+        _mm_storeu_si128((__m128i *) (out + k), _mm_adds_epi16(cost, best));
+    }
+    int16KernelScalar(out + k, x + k, y + k, up + k, left + k, diag + k,
+        count - k);
+}
+
+/* SSE2 has no 32-bit minimum, so one is made from a comparison. */
+__attribute__((target("sse2")))
+static inline __m128i minEpi32SSE2(__m128i a, __m128i b){
+    __m128i aGreater = _mm_cmpgt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(aGreater, b), 
+        _mm_andnot_si128(aGreater, a));
+}
+
+__attribute__((target("sse2")))
+static void int32KernelSSE2(int32_t *out, const int32_t *x, const int32_t *y,
+    const int32_t *up, const int32_t *left, const int32_t *diag, int count){
+    const __m128i infinity = _mm_set1_epi32(INT32_INFINITY);
+    int k = 0;
+    for(; k + 4 <= count; k += 4){
+        __m128i difference = _mm_sub_epi32(
+            _mm_loadu_si128((const __m128i *) (x + k)),
+            _mm_loadu_si128((const __m128i *) (y + k)));
+        __m128i sign = _mm_srai_epi32(difference, 31);
+        __m128i cost = _mm_sub_epi32(_mm_xor_si128(difference, sign), sign);
+        __m128i best = minEpi32SSE2(
+            _mm_loadu_si128((const __m128i *) (up + k)),
+            minEpi32SSE2(_mm_loadu_si128((const __m128i *) (left + k)),
+                _mm_loadu_si128((const __m128i *) (diag + k))));
+        _mm_storeu_si128((__m128i *) (out + k), 
+            minEpi32SSE2(_mm_add_epi32(cost, best), infinity));
+    }
+    int32KernelScalar(out + k, x + k, y + k, up + k, left + k, diag + k,
+        count - k);
+}
+
+__attribute__((target("avx2")))
+static void int16KernelAVX2(int16_t *out, const int16_t *x, const int16_t *y,
+    const int16_t *up, const int16_t *left, const int16_t *diag, int count){
+    int k = 0;
+    for(; k + 16 <= count; k += 16){
+        __m256i cost = _mm256_abs_epi16(_mm256_sub_epi16(
+            _mm256_loadu_si256((const __m256i *) (x + k)),
+            _mm256_loadu_si256((const __m256i *) (y + k))));
+        __m256i best = _mm256_min_epi16(
+            _mm256_loadu_si256((const __m256i *) (up + k)),
+            _mm256_min_epi16(_mm256_loadu_si256((const __m256i *) (left + k)),
+                _mm256_loadu_si256((const __m256i *) (diag + k))));
+        _mm256_storeu_si256((__m256i *) (out + k), 
+            _mm256_adds_epi16(cost, best));
+    }
+    int16KernelScalar(out + k, x + k, y + k, up + k, left + k, diag + k,
+        count - k);
+}
+
+__attribute__((target("avx2")))
+static void int32KernelAVX2(int32_t *out, const int32_t *x, const int32_t *y,
+    const int32_t *up, const int32_t *left, const int32_t *diag, int count){
+    const __m256i infinity = _mm256_set1_epi32(INT32_INFINITY);
+    int k = 0;
+    for(; k + 8 <= count; k += 8){
+        __m256i cost = _mm256_abs_epi32(_mm256_sub_epi32(
+            _mm256_loadu_si256((const __m256i *) (x + k)),
+            _mm256_loadu_si256((const __m256i *) (y + k))));
+        __m256i best = _mm256_min_epi32(
+            _mm256_loadu_si256((const __m256i *) (up + k)),
+            _mm256_min_epi32(_mm256_loadu_si256((const __m256i *) (left + k)),
+                _mm256_loadu_si256((const __m256i *) (diag + k))));
+        _mm256_storeu_si256((__m256i *) (out + k), 
+            _mm256_min_epi32(_mm256_add_epi32(cost, best), infinity));
+    }
+    int32KernelScalar(out + k, x + k, y + k, up + k, left + k, diag + k,
+        count - k);
+}
+#endif
+
+/* Vector instruction sets a kernel can be picked from. */
+enum simdLevel {
+    SIMD_SCALAR = 0,
+    SIMD_SSE2 = 1,
+    SIMD_AVX2 = 2
+};
+
+static enum simdLevel detectSimdLevel(void){
+#ifdef SIMD_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")){
+        return SIMD_AVX2;
+    }
+    if(__builtin_cpu_supports("sse2")){
+        return SIMD_SSE2;
+    }
+#endif
+    return SIMD_SCALAR;
+}
+
+const char *simdKernelName(void){
+    switch(detectSimdLevel()){
+        case SIMD_AVX2:
+            return "AVX2";
+        case SIMD_SSE2:
+            return "SSE2";
+        case SIMD_SCALAR:
+            break;
+    }
+    return "scalar";
+}
+
+static doubleKernel pickDoubleKernel(void){
+    switch(detectSimdLevel()){
+#ifdef SIMD_X86
+        case SIMD_AVX2:
+            return doubleKernelAVX2;
+        case SIMD_SSE2:
+            return doubleKernelSSE2;
+#endif
+        default:
+            break;
+    }
+    return doubleKernelScalar;
+}
+
+static floatKernel pickFloatKernel(void){
+    switch(detectSimdLevel()){
+#ifdef SIMD_X86
+        case SIMD_AVX2:
+            return floatKernelAVX2;
+        case SIMD_SSE2:
+            return floatKernelSSE2;
+#endif
+        default:
+            break;
+    }
+    return floatKernelScalar;
+}
+
+static int16Kernel pickInt16Kernel(void){
+    switch(detectSimdLevel()){
+#ifdef SIMD_X86
+        case SIMD_AVX2:
+            return int16KernelAVX2;
+        case SIMD_SSE2:
+            return int16KernelSSE2;
+#endif
+        default:
+            break;
+    }
+    return int16KernelScalar;
+}
+
+static int32Kernel pickInt32Kernel(void){
+    switch(detectSimdLevel()){
+#ifdef SIMD_X86
+        case SIMD_AVX2:
+            return int32KernelAVX2;
+        case SIMD_SSE2:
+            return int32KernelSSE2;
+#endif
+        default:
+            break;
+    }
+    return int32KernelScalar;
+}
+
+static doubleRowKernel pickDoubleRowKernel(void){
+    switch(detectSimdLevel()){
+#ifdef SIMD_X86
+        case SIMD_AVX2:
+            return doubleRowKernelAVX2;
+        case SIMD_SSE2:
+            return doubleRowKernelSSE2;
+#endif
+        default:
+            break;
+    }
+    return doubleRowKernelScalar;
+}
+
+static floatRowKernel pickFloatRowKernel(void){
+    switch(detectSimdLevel()){
+#ifdef SIMD_X86
+        case SIMD_AVX2:
+            return floatRowKernelAVX2;
+        case SIMD_SSE2:
+            return floatRowKernelSSE2;
+#endif
+        default:
+            break;
+    }
+    return floatRowKernelScalar;
+}
+
+void simdRowDouble(double *out, double x, const double *y, const double *up,
+    const double *left, const double *diag, int count){
+    pickDoubleRowKernel()(out, x, y, up, left, diag, count);
+}
+
+void simdRowFloat(float *out, float x, const float *y, const float *up,
+    const float *left, const float *diag, int count){
+    pickFloatRowKernel()(out, x, y, up, left, diag, count);
+}
+
+static accumulateKernel pickAccumulateKernel(enum stepMetric metric){
+    switch(detectSimdLevel()){
+#ifdef SIMD_X86
+        case SIMD_AVX2:
+            return (metric == METRIC_L2) ? accumulateL2AVX2 : accumulateL1AVX2;
+        case SIMD_SSE2:
+            return (metric == METRIC_L2) ? accumulateL2SSE2 : accumulateL1SSE2;
+#endif
+        default:
+            break;
+    }
+    return (metric == METRIC_L2) ? accumulateL2Scalar : accumulateL1Scalar;
+}
+
+void simdStepDistances(const double *stepsA, int lengthA, int i,
+    const double *stepsB, int lengthB, int jFirst, int count, int dimensions,
+    enum stepMetric metric, long double *out){
+    accumulateKernel accumulate = pickAccumulateKernel(metric);
+    double sums[STEP_DISTANCE_BLOCK];
+    for(int first = 0; first < count; first += STEP_DISTANCE_BLOCK){
+        int blockCount = count - first;
+        if(blockCount > STEP_DISTANCE_BLOCK){
+            blockCount = STEP_DISTANCE_BLOCK;
+        }
+        for(int k = 0; k < blockCount; k++){
+            sums[k] = 0;
+        }
+        /* One contiguous run of sequence B per dimension. */
+        for(int d = 0; d < dimensions; d++){
+            accumulate(sums, stepsA[(size_t) d * lengthA + i],
+                stepsB + (size_t) d * lengthB + jFirst + first, blockCount);
+        }
+        for(int k = 0; k < blockCount; k++){
+            out[first + k] = (metric == METRIC_L2) ? sqrt(sums[k]) : sums[k];
+        }
+    }
+}
+
+/*
+    Defines diagonalDTW<SUFFIX>, the anti-diagonal sweep in the given type,
+    where INF is the type's infinity and WIDEN converts a cell back to long
+    double. offset is subtracted from every value of both sequences first.
+    diagonals[2], diagonals[1] and diagonals[0] hold anti-diagonals d, d - 1
+    and d - 2 by row index. Anti-diagonal d covers rows lo to hi, both of
+    which grow by at most one per anti-diagonal, so marking rows lo - 1 and
+    hi + 1 of each anti-diagonal as infinite is enough for every later read
+    outside the window or matrix to see infinity.
+*/
+#define DEFINE_DIAGONAL_DTW(TYPE, SUFFIX, KERNEL_TYPE, PICK_KERNEL, INF,       \
+    WIDEN)                                                                     \
+static long double diagonalDTW##SUFFIX(long double *seqA, int n,               \
+    long double *seqB, int m, long double offset, int windowSize,              \
+    long double threshold, long double **rows, int *rowStart,                  \
+    struct workspace *workspace){                                              \
+    int i, d;                                                                  \
+    /* Smallest cell of the previous anti-diagonal. */                         \
+    long double previousMin = 0;                                               \
+    KERNEL_TYPE kernel = PICK_KERNEL();                                        \
+    /* Sequence A in order and sequence B reversed. */                         \
+    TYPE *a = (TYPE *) workspaceAlloc(workspace, sizeof(TYPE) * n);            \
+    for(i = 0; i < n; i++){                                                    \
+        a[i] = (TYPE) (seqA[i] - offset);                                      \
+    }                                                                          \
+    TYPE *bReversed = (TYPE *) workspaceAlloc(workspace, sizeof(TYPE) * m);    \
+    for(i = 0; i < m; i++){                                                    \
+        bReversed[i] = (TYPE) (seqB[m - 1 - i] - offset);                      \
+    }                                                                          \
+    TYPE *diagonals[3];                                                        \
+    for(int buffer = 0; buffer < 3; buffer++){                                 \
+        diagonals[buffer] = (TYPE *) workspaceAlloc(workspace,                 \
+            sizeof(TYPE) * (n + 2));                                           \
+        for(i = 0; i < n + 2; i++){                                            \
+            diagonals[buffer][i] = (INF);                                      \
+        }                                                                      \
+    }                                                                          \
+    /* Anti-diagonal 0 is cell (0, 0), anti-diagonal 1 is all boundary. */     \
+    diagonals[1][0] = 0;                                                       \
+                                                                               \
+    for(d = 2; d <= n + m; d++){                                               \
+        TYPE *recycled = diagonals[0];                                         \
+        diagonals[0] = diagonals[1];                                           \
+        diagonals[1] = diagonals[2];                                           \
+        diagonals[2] = recycled;                                               \
+        TYPE *current = diagonals[2];                                          \
+        long long lo = 1;                                                      \
+        if(d - m > lo){                                                        \
+            lo = d - m;                                                        \
+        }                                                                      \
+        if(((long long) d - windowSize + 1) / 2 > lo){                         \
+            lo = ((long long) d - windowSize + 1) / 2;                         \
+        }                                                                      \
+        long long hi = d - 1;                                                  \
+        if(n < hi){                                                            \
+            hi = n;                                                            \
+        }                                                                      \
+        if(((long long) d + windowSize) / 2 < hi){                             \
+            hi = ((long long) d + windowSize) / 2;                             \
+        }                                                                      \
+        if(lo > hi + 1){                                                       \
+            /* Nothing further is inside the window. */                        \
+            break;                                                             \
+        }                                                                      \
+        if(lo <= hi){                                                          \
+            kernel(current + lo, a + lo - 1, bReversed + (m - d + lo),         \
+                diagonals[1] + lo - 1, diagonals[1] + lo,                      \
+                diagonals[0] + lo - 1, (int) (hi - lo + 1));                   \
+        }                                                                      \
+        current[lo - 1] = (INF);                                               \
+        if(hi + 1 <= n){                                                       \
+            current[hi + 1] = (INF);                                           \
+        }                                                                      \
+        if(rows){                                                              \
+            for(long long row = lo; row <= hi; row++){                         \
+                int start = rowStart ? rowStart[row] : 0;                      \
+                rows[row][(d - row) - start] = WIDEN(current[row]);            \
+            }                                                                  \
+        }                                                                      \
+        if(threshold < LDINFINITY){                                            \
+            /* Paths can step diagonally over one anti-diagonal, but never */  \
+            /* over two, so check this one together with the last. */         \
+            long double currentMin = LDINFINITY;                               \
+            for(long long row = lo; row <= hi; row++){                         \
+                if(WIDEN(current[row]) < currentMin){                          \
+                    currentMin = WIDEN(current[row]);                          \
+                }                                                              \
+            }                                                                  \
+            if(currentMin > threshold && previousMin > threshold){             \
+                break;                                                         \
+            }                                                                  \
+            previousMin = currentMin;                                          \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    /* Cell (n, m) is row n of the last anti-diagonal, if it was reached. */   \
+    long double distance = LDINFINITY;                                         \
+    if(d > n + m && diagonals[2][n] != (INF)){                                 \
+        distance = WIDEN(diagonals[2][n]);                                     \
+    }                                                                          \
+                                                                               \
+    for(int buffer = 0; buffer < 3; buffer++){                                 \
+        workspaceFree(workspace, diagonals[buffer]);                           \
+    }                                                                          \
+    workspaceFree(workspace, bReversed);                                       \
+    workspaceFree(workspace, a);                                               \
+                                                                               \
+    return distance;                                                           \
+}
+
+/* Widens a floating point cell, whose infinity stays infinite. */
+#define WIDEN_FLOATING(cell) ((long double) (cell))
+/* Widens an integer cell, mapping its infinity to LDINFINITY. */
+#define WIDEN_INT16(cell) \
+    (((cell) == INT16_INFINITY) ? LDINFINITY : (long double) (cell))
+#define WIDEN_INT32(cell) \
+    (((cell) == INT32_INFINITY) ? LDINFINITY : (long double) (cell))
+
+DEFINE_DIAGONAL_DTW(double, Double, doubleKernel, pickDoubleKernel, 
+    (double) INFINITY, WIDEN_FLOATING)
+DEFINE_DIAGONAL_DTW(float, Float, floatKernel, pickFloatKernel, 
+    (float) INFINITY, WIDEN_FLOATING)
+DEFINE_DIAGONAL_DTW(int16_t, Int16, int16Kernel, pickInt16Kernel, 
+    INT16_INFINITY, WIDEN_INT16)
+DEFINE_DIAGONAL_DTW(int32_t, Int32, int32Kernel, pickInt32Kernel, 
+    INT32_INFINITY, WIDEN_INT32)
+
+/* Returns 1 if cell (n, m) is outside the window. */
+static int endOutsideWindow(int n, int m, int windowSize);
+
+/* Sets lowest and highest to the smallest and largest values of both 
+    sequences. */
+static void valueRange(long double *seqA, int n, long double *seqB, int m,
+    long double *lowest, long double *highest);
+
+static int endOutsideWindow(int n, int m, int windowSize){
+    return windowSize < 0 || (long long) m - n > windowSize ||
+        (long long) n - m > windowSize;
+}
+
+static void valueRange(long double *seqA, int n, long double *seqB, int m,
+    long double *lowest, long double *highest){
+    *lowest = seqA[0];
+    *highest = seqA[0];
+    for(int i = 0; i < n + m; i++){
+        long double value = (i < n) ? seqA[i] : seqB[i - n];
+        if(value < *lowest){
+            *lowest = value;
+        }
+        if(value > *highest){
+            *highest = value;
+        }
+    }
+}
+
+int simdIntegerWidth(long double *seqA, int n, long double *seqB, int m){
+    assert(n > 0 && m > 0);
+    for(int i = 0; i < n + m; i++){
+        long double value = (i < n) ? seqA[i] : seqB[i - n];
+        if(! isfinite(value) || value != floorl(value)){
+            return 0;
+        }
+    }
+    long double lowest, highest;
+    valueRange(seqA, n, seqB, m, &lowest, &highest);
+    /* No warping path has more than n + m - 1 cells. */
+    long double worstTotal = (highest - lowest) * ((long double) n + m - 1);
+    if(worstTotal < INT16_INFINITY){
+        return 16;
+    }
+    if(worstTotal < INT32_INFINITY){
+        return 32;
+    }
+    return 0;
+}
+
+long double simdIntegerDTW(long double *seqA, int n, long double *seqB, 
+    int m, int windowSize, int width, long double threshold, 
+    long double **rows, int *rowStart, struct workspace *workspace){
+    assert(n > 0 && m > 0);
+    if(endOutsideWindow(n, m, windowSize)){
+        return LDINFINITY;
+    }
+    long double lowest, highest;
+    valueRange(seqA, n, seqB, m, &lowest, &highest);
+    if(width == 16){
+        return diagonalDTWInt16(seqA, n, seqB, m, lowest, windowSize, 
+            threshold, rows, rowStart, workspace);
+    }
+    assert(width == 32);
+    return diagonalDTWInt32(seqA, n, seqB, m, lowest, windowSize, threshold,
+        rows, rowStart, workspace);
+}
+
+long double simdDTW(long double *seqA, int n, long double *seqB, int m,
+    int windowSize, enum dtwPrecision precision, long double threshold,
+    long double **rows, int *rowStart, struct workspace *workspace){
+    assert(n > 0 && m > 0);
+    if(endOutsideWindow(n, m, windowSize)){
+        return LDINFINITY;
+    }
+    switch(precision){
+        case PRECISION_DOUBLE:
+            return diagonalDTWDouble(seqA, n, seqB, m, 0, windowSize, 
+                threshold, rows, rowStart, workspace);
+        case PRECISION_FLOAT:
+            return diagonalDTWFloat(seqA, n, seqB, m, 0, windowSize, 
+                threshold, rows, rowStart, workspace);
+        case PRECISION_LONG_DOUBLE:
+            break;
+    }
+    assert(0 && "simdDTW only handles reduced precision");
+    return LDINFINITY;
+}
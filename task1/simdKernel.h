@@ -0,0 +1,84 @@
+/*
+    Header for module which computes DTW matrices in float or double
+        precision, or in integers for whole-number sequences, along 
+        anti-diagonals, so that each anti-diagonal is
+        computed with SSE or AVX2 vector instructions, and rows of cells
+        whose neighbours are all known with the same kernels. Also computes
+        the distances between steps of multivariate sequences.
+*/
+
+#ifndef SIMDKERNEL_H
+#define SIMDKERNEL_H
+
+#include "problem.h"
+#include "workspace.h"
+
+/*
+    Computes the DTW cost between seqA (length n) and seqB (length m) in the
+    given reduced precision (PRECISION_DOUBLE or PRECISION_FLOAT), only
+    visiting cells where |i - j| <= windowSize. Pass a windowSize of at
+    least max(n, m) for an unconstrained DTW.
+
+    If rows is not NULL, every computed cell (i, j) is also written to
+    rows[i][j - rowStart[i]] (or rows[i][j] if rowStart is NULL), widened
+    back to long double. Cells outside the window are left untouched.
+
+    If every cell of two consecutive anti-diagonals exceeds threshold, no
+    path can cost less, so the sweep stops and returns LDINFINITY.
+
+    Only O(n + m) working memory is used besides the optional rows, taken 
+    from the workspace's arena (see workspace.h) if workspace is not NULL.
+*/
+long double simdDTW(long double *seqA, int n, long double *seqB, int m,
+    int windowSize, enum dtwPrecision precision, long double threshold,
+    long double **rows, int *rowStart, struct workspace *workspace);
+
+/*
+    Returns 16 or 32 if every value of seqA (length n) and seqB (length m) 
+    is a whole number and no warping path can cost as much as the largest 
+    cell of that many bits, so simdIntegerDTW with that width gives exactly 
+    the same cells as the long double solvers. Returns the narrower width 
+    if both fit, or 0 if neither does.
+*/
+int simdIntegerWidth(long double *seqA, int n, long double *seqB, int m);
+
+/*
+    Same as simdDTW, but in 16 or 32-bit integers with saturating sums, 
+    where width must come from simdIntegerWidth. Cells inside the window 
+    that no path reaches are written to rows as LDINFINITY.
+*/
+long double simdIntegerDTW(long double *seqA, int n, long double *seqB, 
+    int m, int windowSize, int width, long double threshold, 
+    long double **rows, int *rowStart, struct workspace *workspace);
+
+/*
+    Computes one row of cells in double precision,
+        out[k] = |x - y[k]| + min(up[k], min(left[k], diag[k])) 
+    for k from 0 to count - 1, where every input is already known (as in 
+    a Part F layer, which only reads the layer before it).
+*/
+void simdRowDouble(double *out, double x, const double *y, const double *up,
+    const double *left, const double *diag, int count);
+
+/* Same as simdRowDouble, in single precision. */
+void simdRowFloat(float *out, float x, const float *y, const float *up,
+    const float *left, const float *diag, int count);
+
+/* Steps of sequence B whose distances are summed at a time. */
+#define STEP_DISTANCE_BLOCK 256
+
+/*
+    Sets out[k] to the L1 or L2 distance between step i of stepsA and step 
+    jFirst + k of stepsB, for k from 0 to count - 1, each sequence being 
+    stored as structure-of-arrays (dimensions runs of lengthA or lengthB 
+    values, indexed from 0). Distances are computed in double precision, 
+    a dimension at a time across a block of steps.
+*/
+void simdStepDistances(const double *stepsA, int lengthA, int i,
+    const double *stepsB, int lengthB, int jFirst, int count, int dimensions,
+    enum stepMetric metric, long double *out);
+
+/* Returns the name of the vector instruction set simdDTW will use. */
+const char *simdKernelName(void);
+
+#endif
@@ -10,8 +10,41 @@
         like to add additional fields.
 */
 struct solution {
-    /* The required (n + 1) x (m + 1) matrix. Only for Part A and D. */
+    /* The required (n + 1) x (m + 1) matrix. Only for Part A. */
     long double **matrix;
+    /* For Part D only, the Sakoe-Chiba band of the matrix stored row by row.
+        Row i holds columns (i - bandRadius - 1) to (i + bandRadius + 1), 
+        where the outermost cell on each side is an always-infinite guard. */
+    long double *band;
+    /* For Part D with window shapes other than the Sakoe-Chiba band, the 
+        admissible cells stored row by row. Row i holds columns rangeLo[i] 
+        to rangeHi[i] and starts at rangeCells[rangeOffset[i]] (see 
+        rowRanges.h). */
+    long double *rangeCells;
+    int *rangeLo;
+    int *rangeHi;
+    size_t *rangeOffset;
+    /* For Part A with the tiled layout, the matrix instead, stored as 
+        MATRIX_TILE_SIZE x MATRIX_TILE_SIZE tiles, each row by row, with 
+        tileColumns tiles across each row of tiles. */
+    long double *tiles;
+    int tileColumns;
+    /* The window size the band covers, clamped to the longer sequence. */
+    int bandRadius;
+    /* The number of cells stored per row of the band (2 * bandRadius + 3). */
+    int bandStride;
+    /* 0 if the matrix, band or ranges belong to the problem's workspace instead. */
+    int ownsStorage;
+    /* The workspace whose arena holds the solution and its path, if any. */
+    struct workspace *workspace;
+    /* If asked for, the cells (pathI[k], pathJ[k]) of an optimal warping 
+        path from (1, 1) to (n, m), pathLength of them. */
+    int *pathI;
+    int *pathJ;
+    int pathLength;
     /* The final optimal value (bottom-right value). */
     long double optimalValue;
+    /* 1 if the optimal value is above the problem's threshold, in which
+        case the solver may have stopped before finishing the matrix. */
+    int exceedsThreshold;
 };
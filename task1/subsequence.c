@@ -0,0 +1,335 @@
+/*
+    Implementation for module which finds where a short pattern matches
+        inside a stream under subsequence DTW.
+
+    Column t of the matrix is computed from column t - 1 as in Part A, with
+        row 0 always 0 so a path may start at any position. Alongside each
+        cell's cost is the position its path started at, taken from
+        whichever neighbour it continued from.
+
+    The cheapest candidate match found so far is held back until every cell
+        of the current column either costs more or started after the
+        candidate ended, as then no path that could still beat it overlaps
+        it. Once reported, cells whose paths overlap it are dropped by
+        setting them to infinity.
+
+    A cell keeps only one path, so dropping it can lose a path as cheap
+        that started after the match, leaving the cell's later paths dearer
+        than the best through their span. Ties go to the later start to
+        keep this rare, and each match's distance is recomputed over its
+        span when it is reported, from the stream values kept back to the
+        oldest start a match could still be reported from.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <math.h>
+#include "problem.h"
+#include "subsequence.h"
+
+/* Matches kept for reporting to begin with. */
+#define INITIAL_MATCHES 8
+/* Stream values kept for recomputing matches to begin with. */
+#define INITIAL_HISTORY 64
+
+struct subsequenceSearch {
+    long double *pattern;
+    int n;
+    enum dtwCost cost;
+    long double threshold;
+    /* Number of values in the stream so far. */
+    long long length;
+
+    /* The last column and the one being computed, n + 1 cells each, with
+        the start position of each cell's path. */
+    long double *column;
+    long double *nextColumn;
+    long long *start;
+    long long *nextStart;
+    /* The cost of each pattern value against the current stream value. */
+    long double *costs;
+
+    /* Stream values from position historyStart on, historyLength of them,
+        for recomputing the distance of each match when it is reported. */
+    long double *history;
+    long long historyStart;
+    long long historyLength;
+    long long historyAllocated;
+    /* Two columns for recomputing a match. */
+    long double *spanColumn;
+    long double *spanNextColumn;
+
+    /* The cheapest match not yet reported, if its distance is finite. */
+    struct subsequenceMatch candidate;
+
+    /* Matches reported by the current call. */
+    struct subsequenceMatch *matches;
+    int matchCount;
+    int matchesAllocated;
+};
+
+/* Computes the next column of the matrix for the stream value x. */
+static void subsequenceStep(struct subsequenceSearch *s, long double x);
+
+/* Adds the candidate to the matches reported by the current call, with
+    the DTW distance of its span. */
+static void reportCandidate(struct subsequenceSearch *s);
+
+/* Returns the DTW distance between the pattern and the stream from start
+    to end, which must both still be in the history. */
+static long double spanDistance(struct subsequenceSearch *s, long long start,
+    long long end);
+
+/* Appends x to the history, first dropping the values before the oldest
+    start a match could still be reported from. */
+static void recordValue(struct subsequenceSearch *s, long double x);
+
+struct subsequenceSearch *newSubsequenceSearch(long double *pattern, int n,
+    enum dtwCost cost, long double threshold){
+    assert(pattern && n > 0);
+    struct subsequenceSearch *s = (struct subsequenceSearch *)
+        malloc(sizeof(struct subsequenceSearch));
+    assert(s);
+    s->pattern = pattern;
+    s->n = n;
+    s->cost = cost;
+    s->threshold = threshold;
+    s->length = 0;
+
+    s->column = (long double *) malloc(sizeof(long double) * (n + 1));
+    assert(s->column);
+    s->nextColumn = (long double *) malloc(sizeof(long double) * (n + 1));
+    assert(s->nextColumn);
+    s->start = (long long *) malloc(sizeof(long long) * (n + 1));
+    assert(s->start);
+    s->nextStart = (long long *) malloc(sizeof(long long) * (n + 1));
+    assert(s->nextStart);
+    s->costs = (long double *) malloc(sizeof(long double) * (n + 1));
+    assert(s->costs);
+    s->spanColumn = (long double *) malloc(sizeof(long double) * (n + 1));
+    assert(s->spanColumn);
+    s->spanNextColumn = (long double *) malloc(sizeof(long double) * (n + 1));
+    assert(s->spanNextColumn);
+
+    s->historyAllocated = INITIAL_HISTORY;
+    s->history = (long double *) malloc(sizeof(long double) *
+        s->historyAllocated);
+    assert(s->history);
+    s->historyStart = 1;
+    s->historyLength = 0;
+
+    /* Before the stream starts no path has reached any row. */
+    s->column[0] = 0;
+    s->start[0] = 1;
+    for(int i = 1; i <= n; i++){
+        s->column[i] = LDINFINITY;
+        s->start[i] = 1;
+    }
+
+    s->candidate.start = 0;
+    s->candidate.end = 0;
+    s->candidate.distance = LDINFINITY;
+
+    s->matchesAllocated = INITIAL_MATCHES;
+    s->matches = (struct subsequenceMatch *) malloc(
+        sizeof(struct subsequenceMatch) * s->matchesAllocated);
+    assert(s->matches);
+    s->matchCount = 0;
+
+    return s;
+}
+
+int appendSubsequenceSearch(struct subsequenceSearch *s, long double *values,
+    int count, struct subsequenceMatch **matches){
+    s->matchCount = 0;
+    for(int v = 0; v < count; v++){
+        subsequenceStep(s, values[v]);
+    }
+    *matches = s->matches;
+    return s->matchCount;
+}
+
+int finishSubsequenceSearch(struct subsequenceSearch *s,
+    struct subsequenceMatch **matches){
+    s->matchCount = 0;
+    if(s->candidate.distance <= s->threshold){
+        reportCandidate(s);
+    }
+    *matches = s->matches;
+    return s->matchCount;
+}
+
+static void subsequenceStep(struct subsequenceSearch *s, long double x){
+    int i;
+    int n = s->n;
+    long double *previous = s->column;
+    long double *current = s->nextColumn;
+    long long *previousStart = s->start;
+    long long *currentStart = s->nextStart;
+    recordValue(s, x);
+    long long t = ++(s->length);
+
+    switch(s->cost){
+        case COST_SQUARED:
+            for(i = 1; i <= n; i++){
+                long double difference = x - s->pattern[i - 1];
+                s->costs[i] = difference * difference;
+            }
+            break;
+        default:
+            for(i = 1; i <= n; i++){
+                s->costs[i] = fabsl(x - s->pattern[i - 1]);
+            }
+            break;
+    }
+
+    /* A path leaving row 0, up or diagonally, starts at this value. */
+    previous[0] = 0;
+    previousStart[0] = t;
+    current[0] = 0;
+    currentStart[0] = t;
+    for(i = 1; i <= n; i++){
+        long double best = previous[i - 1];
+        long long bestStart = previousStart[i - 1];
+        if(previous[i] < best || 
+            (previous[i] == best && previousStart[i] > bestStart)){
+            best = previous[i];
+            bestStart = previousStart[i];
+        }
+        if(current[i - 1] < best || 
+            (current[i - 1] == best && currentStart[i - 1] > bestStart)){
+            best = current[i - 1];
+            bestStart = currentStart[i - 1];
+        }
+        current[i] = s->costs[i] + best;
+        currentStart[i] = bestStart;
+    }
+
+    /* Report the candidate once no path that could beat it overlaps it. */
+    if(s->candidate.distance <= s->threshold){
+        int overlapped = 0;
+        for(i = 1; i <= n; i++){
+            if(current[i] < s->candidate.distance && 
+                currentStart[i] <= s->candidate.end){
+                overlapped = 1;
+                break;
+            }
+        }
+        if(! overlapped){
+            reportCandidate(s);
+            for(i = 1; i <= n; i++){
+                if(currentStart[i] <= s->matches[s->matchCount - 1].end){
+                    current[i] = LDINFINITY;
+                }
+            }
+        }
+    }
+    if(current[n] <= s->threshold && current[n] < s->candidate.distance){
+        s->candidate.start = currentStart[n];
+        s->candidate.end = t;
+        s->candidate.distance = current[n];
+    }
+
+    s->column = current;
+    s->nextColumn = previous;
+    s->start = currentStart;
+    s->nextStart = previousStart;
+}
+
+static void reportCandidate(struct subsequenceSearch *s){
+    if(s->matchCount == s->matchesAllocated){
+        s->matchesAllocated *= 2;
+        s->matches = (struct subsequenceMatch *) realloc(s->matches,
+            sizeof(struct subsequenceMatch) * s->matchesAllocated);
+        assert(s->matches);
+    }
+    s->matches[s->matchCount] = s->candidate;
+    s->matches[s->matchCount].distance = spanDistance(s, s->candidate.start,
+        s->candidate.end);
+    s->matchCount++;
+    s->candidate.distance = LDINFINITY;
+}
+
+static long double spanDistance(struct subsequenceSearch *s, long long start,
+    long long end){
+    int n = s->n;
+    long double *previous = s->spanColumn;
+    long double *current = s->spanNextColumn;
+    assert(start >= s->historyStart && 
+        end < s->historyStart + s->historyLength);
+
+    /* Part A's recurrence, with only (0, 0) open in column 0. */
+    previous[0] = 0;
+    for(int i = 1; i <= n; i++){
+        previous[i] = LDINFINITY;
+    }
+    for(long long t = start; t <= end; t++){
+        long double x = s->history[t - s->historyStart];
+        current[0] = LDINFINITY;
+        for(int i = 1; i <= n; i++){
+            long double difference = x - s->pattern[i - 1];
+            long double cost = (s->cost == COST_SQUARED) ?
+                difference * difference : fabsl(difference);
+            long double best = previous[i - 1];
+            if(previous[i] < best){
+                best = previous[i];
+            }
+            if(current[i - 1] < best){
+                best = current[i - 1];
+            }
+            current[i] = cost + best;
+        }
+        long double *swap = previous;
+        previous = current;
+        current = swap;
+    }
+    return previous[n];
+}
+
+static void recordValue(struct subsequenceSearch *s, long double x){
+    /* Only cells within the threshold can still end in a match, and the 
+        first column of a path is the value after its start's row 0. */
+    long long oldest = s->length + 1;
+    if(s->candidate.distance <= s->threshold && s->candidate.start < oldest){
+        oldest = s->candidate.start;
+    }
+    for(int i = 1; i <= s->n; i++){
+        if(s->column[i] <= s->threshold && s->start[i] < oldest){
+            oldest = s->start[i];
+        }
+    }
+
+    if(s->historyLength == s->historyAllocated){
+        long long dropped = oldest - s->historyStart;
+        if(dropped > s->historyLength / 2){
+            memmove(s->history, s->history + dropped, sizeof(long double) *
+                (s->historyLength - dropped));
+            s->historyStart = oldest;
+            s->historyLength -= dropped;
+        } else {
+            s->historyAllocated *= 2;
+            s->history = (long double *) realloc(s->history,
+                sizeof(long double) * s->historyAllocated);
+            assert(s->history);
+        }
+    }
+    s->history[s->historyLength] = x;
+    s->historyLength++;
+}
+
+void freeSubsequenceSearch(struct subsequenceSearch *s){
+    if(! s){
+        return;
+    }
+    free(s->column);
+    free(s->nextColumn);
+    free(s->start);
+    free(s->nextStart);
+    free(s->costs);
+    free(s->spanColumn);
+    free(s->spanNextColumn);
+    free(s->history);
+    free(s->matches);
+    free(s);
+}
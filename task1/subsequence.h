@@ -0,0 +1,63 @@
+/*
+    Header for module which finds where a short pattern matches inside a
+        stream of unbounded length under subsequence DTW, in the manner of
+        SPRING (Sakurai, Faloutsos and Yamamuro).
+
+    Unlike Part A, a match may start and end anywhere in the stream: row 0
+        of the matrix is 0 in every column, and every cell remembers the
+        stream position its path started at. Only the last column is kept,
+        so each sample costs O(n) time, and besides memory linear in the
+        pattern only the stream values since the oldest path still within
+        the threshold are kept.
+
+    Matches are reported as soon as no later path overlapping them could be
+        cheaper, so the matches reported never overlap, and each is the
+        cheapest of those that overlap it.
+*/
+
+#ifndef SUBSEQUENCE_H
+#define SUBSEQUENCE_H
+
+#include "problem.h"
+
+/* A part of the stream matching the pattern. */
+struct subsequenceMatch {
+    /* First and last positions of the match, counting the stream's first
+        value as 1. */
+    long long start;
+    long long end;
+    /* DTW distance between the pattern and this part of the stream, 
+        computed over the span itself when the match is reported. */
+    long double distance;
+};
+
+struct subsequenceSearch;
+
+/*
+    Sets up a search for the pattern of n values in a stream, reporting
+    matches with a DTW distance of at most threshold, with the given cost
+    (see setProblemCost). The pattern is not copied, and must outlive the
+    search.
+*/
+struct subsequenceSearch *newSubsequenceSearch(long double *pattern, int n,
+    enum dtwCost cost, long double threshold);
+
+/*
+    Appends count values to the stream. Sets matches to the matches this
+    reported, oldest first, and returns how many there are. The matches are
+    only valid until the search is next used.
+*/
+int appendSubsequenceSearch(struct subsequenceSearch *s, long double *values,
+    int count, struct subsequenceMatch **matches);
+
+/*
+    Ends the stream, reporting the last match if one is still waiting for
+    later values, as for appendSubsequenceSearch.
+*/
+int finishSubsequenceSearch(struct subsequenceSearch *s,
+    struct subsequenceMatch **matches);
+
+/* Frees the search and all memory allocated for it. */
+void freeSubsequenceSearch(struct subsequenceSearch *s);
+
+#endif
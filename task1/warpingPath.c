@@ -0,0 +1,304 @@
+/*
+    Implementation for module which recovers an optimal DTW warping path
+        using memory linear in the sequence lengths.
+
+    For a rectangle of the matrix from (i0, j0) to (i1, j1), which the path
+        is known to enter at (i0, j0) and leave at (i1, j1), forward[j] is
+        the cost of the cheapest path from (i0, j0) to (mid, j) and
+        backward[j] is the cost of the cheapest path from (mid + 1, j) to
+        (i1, j1). The path crosses from row mid to row mid + 1 with a down
+        or diagonal step, so the cheapest crossing is found by trying both
+        steps from every column of row mid.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include "problem.h"
+#include "warpingPath.h"
+
+/* Everything shared by the recursive calls for one path. */
+struct pathSearch {
+    long double *seqA;
+    long double *seqB;
+    int windowSize;
+    /* One row of costs each, indexed by column. */
+    long double *forward;
+    long double *backward;
+    /* Holds the cells of rectangles solved in full. */
+    long double *cells;
+    /* The path found so far, in order. */
+    int *pathI;
+    int *pathJ;
+    int length;
+};
+
+/* Returns the smaller of a and b, cheaper than fminl as neither is NaN. */
+static inline long double minCost(long double a, long double b);
+
+/* Returns the cost of matching cell (i, j), infinite outside the window. */
+static inline long double cellCost(struct pathSearch *s, int i, int j);
+
+/* Sets lo and hi to the columns of row i within both the window and the
+    columns j0 to j1. */
+static inline void rowRange(struct pathSearch *s, int i, int j0, int j1,
+    int *lo, int *hi);
+
+/* Adds cell (i, j) to the end of the path. */
+static inline void appendCell(struct pathSearch *s, int i, int j);
+
+/*
+    Fills forward with the costs of row iEnd of paths from (i0, j0), setting
+    lo and hi to the columns filled in.
+*/
+static void forwardCosts(struct pathSearch *s, int i0, int j0, int iEnd,
+    int j1, int *lo, int *hi);
+
+/*
+    Fills backward with the costs of row iStart of paths to (i1, j1),
+    setting lo and hi to the columns filled in.
+*/
+static void backwardCosts(struct pathSearch *s, int iStart, int j0, int i1,
+    int j1, int *lo, int *hi);
+
+/* Appends the path through a rectangle small enough to hold in full. */
+static void smallRectanglePath(struct pathSearch *s, int i0, int j0, int i1,
+    int j1);
+
+/* Appends the path from (i0, j0) to (i1, j1). */
+static void rectanglePath(struct pathSearch *s, int i0, int j0, int i1,
+    int j1);
+
+static inline long double minCost(long double a, long double b){
+    return (a < b) ? a : b;
+}
+
+static inline long double cellCost(struct pathSearch *s, int i, int j){
+    if(abs(i - j) > s->windowSize){
+        return LDINFINITY;
+    }
+    return fabsl(s->seqA[i - 1] - s->seqB[j - 1]);
+}
+
+static inline void rowRange(struct pathSearch *s, int i, int j0, int j1,
+    int *lo, int *hi){
+    /* Work in long long so large windows can't overflow. */
+    long long first = (long long) i - s->windowSize;
+    long long last = (long long) i + s->windowSize;
+    *lo = (first > j0) ? (int) first : j0;
+    *hi = (last < j1) ? (int) last : j1;
+}
+
+static inline void appendCell(struct pathSearch *s, int i, int j){
+    s->pathI[s->length] = i;
+    s->pathJ[s->length] = j;
+    s->length++;
+}
+
+static void forwardCosts(struct pathSearch *s, int i0, int j0, int iEnd,
+    int j1, int *lo, int *hi){
+    long double *row = s->forward;
+    int previousLo = 0;
+    int previousHi = -1;
+    for(int i = i0; i <= iEnd; i++){
+        int rowLo, rowHi;
+        rowRange(s, i, j0, j1, &rowLo, &rowHi);
+        /* Cells of the row above outside its range were never filled in. */
+        long double left = LDINFINITY;
+        long double diagonal = LDINFINITY;
+        if(rowLo - 1 >= previousLo && rowLo - 1 <= previousHi){
+            diagonal = row[rowLo - 1];
+        }
+        for(int j = rowLo; j <= rowHi; j++){
+            long double up = LDINFINITY;
+            if(j >= previousLo && j <= previousHi){
+                up = row[j];
+            }
+            long double best = minCost(up, minCost(left, diagonal));
+            if(i == i0 && j == j0){
+                best = 0;
+            }
+            row[j] = cellCost(s, i, j) + best;
+            left = row[j];
+            diagonal = up;
+        }
+        previousLo = rowLo;
+        previousHi = rowHi;
+    }
+    *lo = previousLo;
+    *hi = previousHi;
+}
+
+static void backwardCosts(struct pathSearch *s, int iStart, int j0, int i1,
+    int j1, int *lo, int *hi){
+    long double *row = s->backward;
+    int previousLo = 0;
+    int previousHi = -1;
+    for(int i = i1; i >= iStart; i--){
+        int rowLo, rowHi;
+        rowRange(s, i, j0, j1, &rowLo, &rowHi);
+        /* Cells of the row below outside its range were never filled in. */
+        long double right = LDINFINITY;
+        long double diagonal = LDINFINITY;
+        if(rowHi + 1 >= previousLo && rowHi + 1 <= previousHi){
+            diagonal = row[rowHi + 1];
+        }
+        for(int j = rowHi; j >= rowLo; j--){
+            long double down = LDINFINITY;
+            if(j >= previousLo && j <= previousHi){
+                down = row[j];
+            }
+            long double best = minCost(down, minCost(right, diagonal));
+            if(i == i1 && j == j1){
+                best = 0;
+            }
+            row[j] = cellCost(s, i, j) + best;
+            right = row[j];
+            diagonal = down;
+        }
+        previousLo = rowLo;
+        previousHi = rowHi;
+    }
+    *lo = previousLo;
+    *hi = previousHi;
+}
+
+static void smallRectanglePath(struct pathSearch *s, int i0, int j0, int i1,
+    int j1){
+    int rows = i1 - i0 + 1;
+    int columns = j1 - j0 + 1;
+    long double *cells = s->cells;
+    assert(rows * columns <= WARPING_PATH_BASE_CELLS);
+
+    for(int r = 0; r < rows; r++){
+        for(int c = 0; c < columns; c++){
+            long double best = LDINFINITY;
+            if(r == 0 && c == 0){
+                best = 0;
+            }
+            if(r > 0){
+                best = minCost(best, cells[(r - 1) * columns + c]);
+            }
+            if(c > 0){
+                best = minCost(best, cells[r * columns + (c - 1)]);
+            }
+            if(r > 0 && c > 0){
+                best = minCost(best, cells[(r - 1) * columns + (c - 1)]);
+            }
+            cells[r * columns + c] = cellCost(s, i0 + r, j0 + c) + best;
+        }
+    }
+
+    /* Walk back from the end, which fills the path in backwards,
+        preferring diagonal steps on ties. */
+    int cellCount = 0;
+    int r = rows - 1;
+    int c = columns - 1;
+    int start = s->length;
+    while(1){
+        s->pathI[start + cellCount] = i0 + r;
+        s->pathJ[start + cellCount] = j0 + c;
+        cellCount++;
+        if(r == 0 && c == 0){
+            break;
+        }
+        if(r > 0 && c > 0 &&
+            cells[(r - 1) * columns + (c - 1)] <= cells[(r - 1) * columns + c] &&
+            cells[(r - 1) * columns + (c - 1)] <= cells[r * columns + (c - 1)]){
+            r--;
+            c--;
+        } else if(c == 0 || (r > 0 &&
+            cells[(r - 1) * columns + c] <= cells[r * columns + (c - 1)])){
+            r--;
+        } else {
+            c--;
+        }
+    }
+    for(int k = 0; k < cellCount / 2; k++){
+        int swapI = s->pathI[start + k];
+        int swapJ = s->pathJ[start + k];
+        s->pathI[start + k] = s->pathI[start + cellCount - 1 - k];
+        s->pathJ[start + k] = s->pathJ[start + cellCount - 1 - k];
+        s->pathI[start + cellCount - 1 - k] = swapI;
+        s->pathJ[start + cellCount - 1 - k] = swapJ;
+    }
+    s->length += cellCount;
+}
+
+static void rectanglePath(struct pathSearch *s, int i0, int j0, int i1,
+    int j1){
+    if(i0 == i1){
+        /* A single row can only be crossed one way. */
+        for(int j = j0; j <= j1; j++){
+            appendCell(s, i0, j);
+        }
+        return;
+    }
+    if(j0 == j1){
+        for(int i = i0; i <= i1; i++){
+            appendCell(s, i, j0);
+        }
+        return;
+    }
+    if((long long) (i1 - i0 + 1) * (j1 - j0 + 1) <= WARPING_PATH_BASE_CELLS){
+        smallRectanglePath(s, i0, j0, i1, j1);
+        return;
+    }
+
+    int mid = i0 + (i1 - i0) / 2;
+    int forwardLo, forwardHi, backwardLo, backwardHi;
+    forwardCosts(s, i0, j0, mid, j1, &forwardLo, &forwardHi);
+    backwardCosts(s, mid + 1, j0, i1, j1, &backwardLo, &backwardHi);
+
+    /* Find the cheapest step from row mid into row mid + 1. */
+    long double bestCost = LDINFINITY;
+    int bestFrom = -1;
+    int bestTo = -1;
+    for(int j = forwardLo; j <= forwardHi; j++){
+        for(int to = j; to <= j + 1; to++){
+            if(to < backwardLo || to > backwardHi){
+                continue;
+            }
+            long double cost = s->forward[j] + s->backward[to];
+            if(bestFrom == -1 || cost < bestCost){
+                bestCost = cost;
+                bestFrom = j;
+                bestTo = to;
+            }
+        }
+    }
+    assert(bestFrom != -1);
+
+    rectanglePath(s, i0, j0, mid, bestFrom);
+    rectanglePath(s, mid + 1, bestTo, i1, j1);
+}
+
+int warpingPath(long double *seqA, int n, long double *seqB, int m,
+    int windowSize, int *pathI, int *pathJ, struct workspace *workspace){
+    if(n < 1 || m < 1 || abs(n - m) > windowSize){
+        /* The end can't be reached within the window. */
+        return 0;
+    }
+
+    struct pathSearch s;
+    s.seqA = seqA;
+    s.seqB = seqB;
+    s.windowSize = windowSize;
+    s.forward = (long double *) workspaceAlloc(workspace, 
+        sizeof(long double) * (m + 1));
+    s.backward = (long double *) workspaceAlloc(workspace, 
+        sizeof(long double) * (m + 1));
+    s.cells = (long double *) workspaceAlloc(workspace, 
+        sizeof(long double) * WARPING_PATH_BASE_CELLS);
+    s.pathI = pathI;
+    s.pathJ = pathJ;
+    s.length = 0;
+
+    rectanglePath(&s, 1, 1, n, m);
+
+    workspaceFree(workspace, s.forward);
+    workspaceFree(workspace, s.backward);
+    workspaceFree(workspace, s.cells);
+
+    return s.length;
+}
@@ -0,0 +1,36 @@
+/*
+    Header for module which recovers an optimal DTW warping path using
+        memory linear in the sequence lengths.
+
+    Like Hirschberg's algorithm, the matrix is split at its middle row, the
+        best cell to cross between the two halves is found from costs
+        computed forwards over the top half and backwards over the bottom
+        half, and each half is then solved recursively.
+*/
+
+#ifndef WARPINGPATH_H
+#define WARPINGPATH_H
+
+#include "workspace.h"
+
+/* Rectangles with at most this many cells are solved with a full matrix,
+    which saves the deepest, narrowest levels of the recursion. */
+#define WARPING_PATH_BASE_CELLS 65536
+
+/*
+    Finds an optimal warping path between seqA (length n) and seqB (length
+    m), only using cells where |i - j| <= windowSize. Pass a windowSize of at
+    least max(n, m) for an unconstrained DTW.
+
+    The path's cells are written in order from (1, 1) to (n, m) to pathI and
+    pathJ, which must each have room for n + m - 1 cells, and the number of
+    cells is returned. Returns 0 if the window allows no path.
+
+    Takes about twice the time of filling in the matrix, but only O(n + m)
+    working memory, taken from the workspace's arena (see workspace.h) if 
+    workspace is not NULL.
+*/
+int warpingPath(long double *seqA, int n, long double *seqB, int m,
+    int windowSize, int *pathI, int *pathJ, struct workspace *workspace);
+
+#endif
@@ -0,0 +1,232 @@
+/*
+    Implementation for module which computes DTW matrices in parallel by
+        sweeping square tiles of the matrix along anti-diagonals.
+
+    Instead of the whole matrix, only the last row computed in each column
+        of tiles, the last column computed in each row of tiles and the
+        bottom-right corner of each tile are kept, which is all a tile needs
+        from its up, left and diagonal neighbours.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include <pthread.h>
+#include "problem.h"
+#include "wavefront.h"
+
+/* Everything shared by the threads working on one matrix. */
+struct wavefront {
+    long double *seqA;
+    int n;
+    long double *seqB;
+    int m;
+    int windowSize;
+    int threadCount;
+    /* Number of tiles down and across the matrix. */
+    int tileRows;
+    int tileColumns;
+    /* horizontal[j] is cell (i, j) for the last row i computed in the
+        column of tiles containing column j. Starts as row 0. */
+    long double *horizontal;
+    /* vertical[i] is cell (i, j) for the last column j computed in the
+        row of tiles containing row i. Starts as column 0. */
+    long double *vertical;
+    /* corners[I * (tileColumns + 1) + J] is the cell diagonally above and
+        to the left of tile (I, J). */
+    long double *corners;
+    /* Optional output of every computed cell. */
+    long double **rows;
+    int *rowStart;
+    pthread_barrier_t barrier;
+};
+
+/* One thread's share of the work. */
+struct wavefrontThread {
+    struct wavefront *w;
+    int threadIndex;
+};
+
+/* Returns 1 if any cell of tile (I, J) lies within the window. */
+static int tileInWindow(struct wavefront *w, int tileRow, int tileColumn);
+
+/* Computes every cell of tile (I, J). */
+static void computeTile(struct wavefront *w, int tileRow, int tileColumn);
+
+/* Sweeps the anti-diagonals of tiles, computing this thread's tiles. */
+static void *wavefrontWorker(void *arg);
+
+static int tileInWindow(struct wavefront *w, int tileRow, int tileColumn){
+    int firstRow = 1 + tileRow * WAVEFRONT_TILE_SIZE;
+    int lastRow = firstRow + WAVEFRONT_TILE_SIZE - 1;
+    int firstColumn = 1 + tileColumn * WAVEFRONT_TILE_SIZE;
+    int lastColumn = firstColumn + WAVEFRONT_TILE_SIZE - 1;
+    if(lastRow > w->n){
+        lastRow = w->n;
+    }
+    if(lastColumn > w->m){
+        lastColumn = w->m;
+    }
+    /* Work in long long so large windows can't overflow. */
+    return ((long long) firstColumn <= (long long) lastRow + w->windowSize) &&
+        ((long long) lastColumn >= (long long) firstRow - w->windowSize);
+}
+
+static void computeTile(struct wavefront *w, int tileRow, int tileColumn){
+    int i, j;
+    int firstRow = 1 + tileRow * WAVEFRONT_TILE_SIZE;
+    int lastRow = firstRow + WAVEFRONT_TILE_SIZE - 1;
+    int firstColumn = 1 + tileColumn * WAVEFRONT_TILE_SIZE;
+    int lastColumn = firstColumn + WAVEFRONT_TILE_SIZE - 1;
+    if(lastRow > w->n){
+        lastRow = w->n;
+    }
+    if(lastColumn > w->m){
+        lastColumn = w->m;
+    }
+    int cornerStride = w->tileColumns + 1;
+
+    /* Cell (i - 1, firstColumn - 1). */
+    long double diagonalLeft = w->corners[tileRow * cornerStride + tileColumn];
+    long double cost;
+    for(i = firstRow; i <= lastRow; i++){
+        /* Cell (i, firstColumn - 1). */
+        long double left = w->vertical[i];
+        long double upLeft = diagonalLeft;
+        diagonalLeft = left;
+        long long windowStart = (long long) i - w->windowSize;
+        long long windowEnd = (long long) i + w->windowSize;
+        long double *row = NULL;
+        int rowStart = 0;
+        if(w->rows){
+            row = w->rows[i];
+            rowStart = w->rowStart ? w->rowStart[i] : 0;
+        }
+        for(j = firstColumn; j <= lastColumn; j++){
+            /* Cell (i - 1, j), about to be replaced by cell (i, j). */
+            long double up = w->horizontal[j];
+            long double value;
+            if(j >= windowStart && j <= windowEnd){
+                cost = fabsl(w->seqA[i-1] - w->seqB[j-1]);
+                value = cost + fminl(up, fminl(left, upLeft));
+                if(row){
+                    row[j - rowStart] = value;
+                }
+            } else {
+                value = LDINFINITY;
+            }
+            w->horizontal[j] = value;
+            upLeft = up;
+            left = value;
+        }
+        w->vertical[i] = left;
+    }
+    w->corners[(tileRow + 1) * cornerStride + (tileColumn + 1)] =
+        w->horizontal[lastColumn];
+}
+
+static void *wavefrontWorker(void *arg){
+    struct wavefrontThread *thread = (struct wavefrontThread *) arg;
+    struct wavefront *w = thread->w;
+    int tileDiagonals = w->tileRows + w->tileColumns - 1;
+
+    for(int d = 0; d < tileDiagonals; d++){
+        int firstTileRow = (d - (w->tileColumns - 1) > 0) ?
+            (d - (w->tileColumns - 1)) : 0;
+        int lastTileRow = (d < w->tileRows - 1) ? d : (w->tileRows - 1);
+        /* Deal tiles in the window out round-robin among threads. */
+        int tilesInWindow = 0;
+        for(int tileRow = firstTileRow; tileRow <= lastTileRow; tileRow++){
+            int tileColumn = d - tileRow;
+            if(! tileInWindow(w, tileRow, tileColumn)){
+                continue;
+            }
+            if(tilesInWindow % w->threadCount == thread->threadIndex){
+                computeTile(w, tileRow, tileColumn);
+            }
+            tilesInWindow++;
+        }
+        pthread_barrier_wait(&(w->barrier));
+    }
+
+    return NULL;
+}
+
+long double wavefrontDTW(long double *seqA, int n, long double *seqB, int m,
+    int windowSize, int threadCount, long double **rows, int *rowStart,
+    struct workspace *workspace){
+    struct wavefront w;
+    int i, j;
+
+    assert(n > 0 && m > 0);
+    if(threadCount < 1){
+        threadCount = 1;
+    }
+
+    w.seqA = seqA;
+    w.n = n;
+    w.seqB = seqB;
+    w.m = m;
+    w.windowSize = windowSize;
+    w.threadCount = threadCount;
+    w.tileRows = (n + WAVEFRONT_TILE_SIZE - 1) / WAVEFRONT_TILE_SIZE;
+    w.tileColumns = (m + WAVEFRONT_TILE_SIZE - 1) / WAVEFRONT_TILE_SIZE;
+    w.rows = rows;
+    w.rowStart = rowStart;
+
+    /* Row 0 and column 0 of the DTW matrix. */
+    w.horizontal = (long double *) workspaceAlloc(workspace, 
+        sizeof(long double) * (m + 1));
+    for(j = 0; j <= m; j++){
+        w.horizontal[j] = LDINFINITY;
+    }
+    w.vertical = (long double *) workspaceAlloc(workspace, 
+        sizeof(long double) * (n + 1));
+    for(i = 0; i <= n; i++){
+        w.vertical[i] = LDINFINITY;
+    }
+    /* Tiles never computed lie outside the window, so stay infinite. */
+    size_t cornerCount = (size_t) (w.tileRows + 1) * (w.tileColumns + 1);
+    w.corners = (long double *) workspaceAlloc(workspace, 
+        sizeof(long double) * cornerCount);
+    for(size_t c = 0; c < cornerCount; c++){
+        w.corners[c] = LDINFINITY;
+    }
+    w.corners[0] = 0;
+
+    pthread_barrier_init(&(w.barrier), NULL, threadCount);
+    pthread_t *threads = (pthread_t *) workspaceAlloc(workspace, 
+        sizeof(pthread_t) * threadCount);
+    struct wavefrontThread *threadArgs = (struct wavefrontThread *)
+        workspaceAlloc(workspace, sizeof(struct wavefrontThread) * threadCount);
+
+    /* The calling thread does the first share of the work itself. */
+    for(int t = 0; t < threadCount; t++){
+        threadArgs[t].w = &w;
+        threadArgs[t].threadIndex = t;
+        if(t > 0){
+            int status = pthread_create(&threads[t], NULL, wavefrontWorker,
+                &threadArgs[t]);
+            assert(status == 0);
+        }
+    }
+    wavefrontWorker(&threadArgs[0]);
+    for(int t = 1; t < threadCount; t++){
+        pthread_join(threads[t], NULL);
+    }
+
+    /* Cell (n, m) was the last cell of the last column's final row. */
+    long double distance = w.horizontal[m];
+    if((long long) m - n > windowSize || (long long) n - m > windowSize){
+        distance = LDINFINITY;
+    }
+
+    pthread_barrier_destroy(&(w.barrier));
+    workspaceFree(workspace, threads);
+    workspaceFree(workspace, threadArgs);
+    workspaceFree(workspace, w.corners);
+    workspaceFree(workspace, w.vertical);
+    workspaceFree(workspace, w.horizontal);
+
+    return distance;
+}
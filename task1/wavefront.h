@@ -0,0 +1,35 @@
+/*
+    Header for module which computes DTW matrices in parallel by
+        sweeping square tiles of the matrix along anti-diagonals.
+
+    Tiles on the same anti-diagonal only depend on tiles from earlier
+        anti-diagonals, so they are shared out among the threads, which
+        wait for each other before moving to the next anti-diagonal.
+*/
+
+#ifndef WAVEFRONT_H
+#define WAVEFRONT_H
+
+#include "workspace.h"
+
+/* Side length of the square tiles the matrix is split into. */
+#define WAVEFRONT_TILE_SIZE 256
+
+/*
+    Computes the DTW cost between seqA (length n) and seqB (length m), only
+    visiting cells where |i - j| <= windowSize, using threadCount threads.
+    Pass a windowSize of at least max(n, m) for an unconstrained DTW.
+
+    If rows is not NULL, every computed cell (i, j) is also written to
+    rows[i][j - rowStart[i]] (or rows[i][j] if rowStart is NULL). Cells
+    outside the window are left untouched.
+
+    Only O(n + m) working memory is used besides the optional rows, taken 
+    from the workspace's arena (see workspace.h) if workspace is not NULL.
+    Starting the threads still allocates their own memory.
+*/
+long double wavefrontDTW(long double *seqA, int n, long double *seqB, int m,
+    int windowSize, int threadCount, long double **rows, int *rowStart,
+    struct workspace *workspace);
+
+#endif
@@ -0,0 +1,171 @@
+/*
+    Implementation for module which keeps buffers for the DTW solvers
+        between calls.
+
+    Each buffer only ever grows, so once the workspace has solved the
+        largest problem it will see, later solves allocate nothing.
+
+    The arena hands out memory from the end of its newest block, starting
+        a block twice the size when that is full. Memory given back is only
+        reclaimed once everything has been, when any older blocks are
+        merged into one, so the arena settles into a single block.
+*/
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include "workspace.h"
+
+/* Bytes of the first block of the arena. */
+#define ARENA_FIRST_BLOCK_SIZE 65536
+
+/* A block of the arena, followed in memory by its cells. */
+struct arenaBlock {
+    /* The block started before this one, if any. */
+    struct arenaBlock *previous;
+    /* Bytes of cells, and how many of them have been handed out. */
+    size_t size;
+    size_t used;
+};
+
+struct workspace {
+    /* The buffers, NULL until first used. */
+    void *buffers[WORKSPACE_BUFFER_COUNT];
+    /* The number of bytes allocated for each buffer. */
+    size_t sizes[WORKSPACE_BUFFER_COUNT];
+    /* The newest block of the arena, NULL until first used. */
+    struct arenaBlock *arena;
+    /* The number of pieces of the arena not yet given back. */
+    size_t arenaPieces;
+};
+
+/* Allocates a block of the arena with the given bytes of cells. */
+static struct arenaBlock *newArenaBlock(size_t size, 
+    struct arenaBlock *previous);
+
+/* Returns the first cell of the given block, aligned to 
+    WORKSPACE_ALIGNMENT. */
+static unsigned char *arenaCells(struct arenaBlock *block);
+
+static struct arenaBlock *newArenaBlock(size_t size, 
+    struct arenaBlock *previous){
+    /* Room to move the cells up to the alignment. */
+    struct arenaBlock *block = (struct arenaBlock *) 
+        malloc(sizeof(struct arenaBlock) + WORKSPACE_ALIGNMENT + size);
+    assert(block);
+    block->previous = previous;
+    block->size = size;
+    block->used = 0;
+    return block;
+}
+
+static unsigned char *arenaCells(struct arenaBlock *block){
+    uintptr_t first = (uintptr_t) (block + 1);
+    first = (first + WORKSPACE_ALIGNMENT - 1) & 
+        ~((uintptr_t) WORKSPACE_ALIGNMENT - 1);
+    return (unsigned char *) first;
+}
+
+struct workspace *newWorkspace(void){
+    struct workspace *w = (struct workspace *) malloc(sizeof(struct workspace));
+    assert(w);
+    for(int i = 0; i < WORKSPACE_BUFFER_COUNT; i++){
+        w->buffers[i] = NULL;
+        w->sizes[i] = 0;
+    }
+    w->arena = NULL;
+    w->arenaPieces = 0;
+    return w;
+}
+
+void *workspaceBuffer(struct workspace *w, enum workspaceBuffer buffer,
+    size_t bytes){
+    assert(w);
+    assert(buffer >= 0 && buffer < WORKSPACE_BUFFER_COUNT);
+    if(bytes > w->sizes[buffer]){
+        /* Contents needn't be kept, so free rather than realloc. */
+        free(w->buffers[buffer]);
+        w->buffers[buffer] = malloc(bytes);
+        assert(w->buffers[buffer]);
+        w->sizes[buffer] = bytes;
+    }
+    return w->buffers[buffer];
+}
+
+void *workspaceAlloc(struct workspace *w, size_t bytes){
+    if(! w){
+        void *memory = malloc(bytes);
+        assert(memory);
+        return memory;
+    }
+    /* Every piece starts aligned, and empty ones are still distinct. */
+    size_t rounded = (bytes + WORKSPACE_ALIGNMENT - 1) / WORKSPACE_ALIGNMENT * 
+        WORKSPACE_ALIGNMENT;
+    if(rounded == 0){
+        rounded = WORKSPACE_ALIGNMENT;
+    }
+    if(! w->arena || w->arena->used + rounded > w->arena->size){
+        size_t size = w->arena ? 2 * w->arena->size : ARENA_FIRST_BLOCK_SIZE;
+        if(size < rounded){
+            size = rounded;
+        }
+        w->arena = newArenaBlock(size, w->arena);
+    }
+    void *memory = arenaCells(w->arena) + w->arena->used;
+    w->arena->used += rounded;
+    w->arenaPieces++;
+    return memory;
+}
+
+void workspaceFree(struct workspace *w, void *memory){
+    if(! w){
+        free(memory);
+        return;
+    }
+    if(! memory){
+        return;
+    }
+    assert(w->arenaPieces > 0);
+    w->arenaPieces--;
+    if(w->arenaPieces > 0){
+        return;
+    }
+    if(w->arena->previous){
+        /* Merge the blocks into one big enough for all of them. */
+        size_t size = 0;
+        struct arenaBlock *block = w->arena;
+        while(block){
+            struct arenaBlock *previous = block->previous;
+            size += block->size;
+            free(block);
+            block = previous;
+        }
+        w->arena = newArenaBlock(size, NULL);
+    }
+    w->arena->used = 0;
+}
+
+size_t workspaceSize(struct workspace *w){
+    size_t total = 0;
+    for(int i = 0; i < WORKSPACE_BUFFER_COUNT; i++){
+        total += w->sizes[i];
+    }
+    for(struct arenaBlock *block = w->arena; block; block = block->previous){
+        total += block->size;
+    }
+    return total;
+}
+
+void freeWorkspace(struct workspace *w){
+    if(w){
+        for(int i = 0; i < WORKSPACE_BUFFER_COUNT; i++){
+            free(w->buffers[i]);
+        }
+        struct arenaBlock *block = w->arena;
+        while(block){
+            struct arenaBlock *previous = block->previous;
+            free(block);
+            block = previous;
+        }
+        free(w);
+    }
+}
@@ -0,0 +1,73 @@
+/*
+    Header for module which keeps buffers for the DTW solvers between
+        calls, so that solving many problems of similar size reuses the
+        same memory instead of allocating and freeing it each time.
+
+    Besides the named buffers, each of which holds one use at a time, a 
+        workspace has an arena for the smaller pieces of a solve (the 
+        solution itself, its path and the engines' working vectors), which 
+        are taken and given back in any order.
+*/
+
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+
+#include <stddef.h>
+
+/* Alignment of memory from the arena, a cache line (and so enough for 
+    any vector kernel). */
+#define WORKSPACE_ALIGNMENT 64
+
+/* The buffers a workspace keeps, one per use within a solve. */
+enum workspaceBuffer {
+    WORKSPACE_MATRIX_ROWS = 0,
+    WORKSPACE_MATRIX_CELLS = 1,
+    WORKSPACE_BAND = 2,
+    WORKSPACE_BAND_ROWS = 3,
+    WORKSPACE_BAND_ROW_STARTS = 4,
+    WORKSPACE_ROLLING_ROWS = 5,
+    WORKSPACE_LAYER_ROWS = 6,
+    WORKSPACE_LAYER_CELLS = 7,
+    WORKSPACE_STEP_COSTS = 8,
+    WORKSPACE_RANGE_BOUNDS = 9,
+    WORKSPACE_RANGE_OFFSETS = 10,
+    WORKSPACE_RANGE_CELLS = 11,
+    WORKSPACE_RANGE_ABOVE = 12,
+    WORKSPACE_BUFFER_COUNT = 13
+};
+
+struct workspace;
+
+/* Creates a workspace with no buffers allocated yet. */
+struct workspace *newWorkspace(void);
+
+/*
+    Returns the given buffer of the workspace, grown to at least the given
+    number of bytes. Its previous contents are not kept.
+*/
+void *workspaceBuffer(struct workspace *w, enum workspaceBuffer buffer,
+    size_t bytes);
+
+/*
+    Returns bytes of memory from the workspace's arena, aligned to 
+    WORKSPACE_ALIGNMENT, or from malloc if w is NULL. Memory is never 
+    moved, and stays valid until given to workspaceFree.
+*/
+void *workspaceAlloc(struct workspace *w, size_t bytes);
+
+/*
+    Gives back memory from workspaceAlloc with the same workspace (or 
+    frees it if w is NULL). Once all of it has been given back the arena 
+    starts again from the beginning, in a single block as big as the most 
+    it ever held at once, so a workspace which has seen its largest solve 
+    allocates nothing more.
+*/
+void workspaceFree(struct workspace *w, void *memory);
+
+/* Returns the total bytes currently held by the workspace. */
+size_t workspaceSize(struct workspace *w);
+
+/* Frees the workspace and all its buffers. */
+void freeWorkspace(struct workspace *w);
+
+#endif